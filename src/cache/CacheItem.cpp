@@ -15,6 +15,7 @@
 */
 
 #include "CacheItem.h"
+#include "CacheItemLayouts.h"
 #include "core/View.h"
 #include "core/ControllerMouse.h"
 
@@ -41,20 +42,23 @@ CacheItemInfo& CacheItemInfo::operator=(const CacheItemInfo& other)
 
 CacheItem::CacheItem(ID id)
     : CacheItemInfo(id),
-      m_isCacheViewValid(false)
+      m_isCacheViewValid(false),
+      m_layouts(nullptr)
 {
 }
 
 CacheItem::CacheItem(const CacheItemInfo& info)
     : CacheItemInfo(info),
-      m_isCacheViewValid(false)
+      m_isCacheViewValid(false),
+      m_layouts(nullptr)
 {
 }
 
 CacheItem::CacheItem(const CacheItem& other)
     : CacheItemInfo(other),
-      m_cacheView(other.m_cacheView),
-      m_isCacheViewValid(other.m_isCacheViewValid)
+      m_cacheViews(other.m_cacheViews),
+      m_isCacheViewValid(other.m_isCacheViewValid),
+      m_layouts(other.m_layouts)
 {
 }
 
@@ -62,20 +66,28 @@ CacheItem& CacheItem::operator=(const CacheItem& other)
 {
     CacheItemInfo::operator =(other);
 
-    m_cacheView = other.m_cacheView;
+    m_cacheViews = other.m_cacheViews;
     m_isCacheViewValid = other.m_isCacheViewValid;
+    m_layouts = other.m_layouts;
 
     return *this;
 }
 
+void CacheItem::reset(const CacheItemInfo& info)
+{
+    CacheItemInfo::operator =(info);
+    invalidateCacheView();
+    drawProxy = nullptr;
+}
+
 const CacheView2* CacheItem::findCacheViewByController(const ControllerMouse* controller) const
 {
-    if (!m_isCacheViewValid || !m_cacheView)
+    if (!m_isCacheViewValid || m_cacheViews.isEmpty())
         return nullptr;
 
     const CacheView2* result = nullptr;
 
-    m_cacheView->forEachCacheView([&result, controller](const CacheView2* cacheView)->bool {
+    cacheView()->forEachCacheView([&result, controller](const CacheView2* cacheView)->bool {
         if (cacheView->view()->controller().data() == controller)
         {
             result = cacheView;
@@ -90,7 +102,8 @@ const CacheView2* CacheItem::findCacheViewByController(const ControllerMouse* co
 
 void CacheItem::invalidateCacheView()
 {
-    m_cacheView.reset();
+    // resize() keeps capacity for the next validation
+    m_cacheViews.resize(0);
     m_isCacheViewValid = false;
 }
 
@@ -111,13 +124,8 @@ void CacheItem::correctRectangles(const QPoint &offset)
 //    }
 
     // just offset all rects
-    if (m_cacheView)
-    {
-        m_cacheView->forEachCacheView([&offset](CacheView2* cacheView)->bool {
-            cacheView->rRect().translate(offset);
-            return true;
-        });
-    }
+    for (auto& cacheView : m_cacheViews)
+        cacheView.rRect().translate(offset);
 }
 QString CacheItem::text() const
 {
@@ -141,13 +149,13 @@ void CacheItem::drawRaw(QPainter *painter, const GuiContext& ctx, const QRect* v
 {
     validateCacheView(ctx, visibleRect);
 
-    if (!m_cacheView)
+    if (m_cacheViews.isEmpty())
         return;
 
     //*ctx.PreDrawCell(m_rect);
 
-    m_cacheView->draw(painter, ctx, id, rect, visibleRect);
-    m_cacheView->cleanupDraw(painter, ctx, id, rect, visibleRect);
+    cacheView()->draw(painter, ctx, id, rect, visibleRect);
+    cacheView()->cleanupDraw(painter, ctx, id, rect, visibleRect);
 
     //*ctx.PostDrawCell();
 }
@@ -155,14 +163,14 @@ void CacheItem::drawRaw(QPainter *painter, const GuiContext& ctx, const QRect* v
 void CacheItem::tryActivateControllers(const ControllerContext& context, const CacheSpace& cacheSpace, const QRect* visibleRect, QVector<ControllerMouse*>& controllers) const
 {
     // don't handle if CacheCellEx is not ready yet
-    if (!m_isCacheViewValid || !m_cacheView)
+    if (!m_isCacheViewValid || m_cacheViews.isEmpty())
         return;
 
     typedef QPair<ControllerMouse*, const CacheView2*> ControllerInfo_t;
     QVector<ControllerInfo_t> itemControllersInfo;
 
     // collect affected controllers
-    m_cacheView->forEachCacheView([&itemControllersInfo, &context](const CacheView2* cacheView)->bool {
+    cacheView()->forEachCacheView([&itemControllersInfo, &context](const CacheView2* cacheView)->bool {
         if (!cacheView->view()->controller())
             return true;
 
@@ -182,8 +190,8 @@ void CacheItem::tryActivateControllers(const ControllerContext& context, const C
         return left.first->priority() < right.first->priority();
     });
 
-    // m_cacheView should exists at this time
-    Q_ASSERT(m_cacheView);
+    // m_cacheViews should exists at this time
+    Q_ASSERT(!m_cacheViews.isEmpty());
 
     // activate controllers in reversed order
     for (int i = itemControllersInfo.size() - 1; i >= 0; --i)
@@ -191,7 +199,7 @@ void CacheItem::tryActivateControllers(const ControllerContext& context, const C
         itemControllersInfo[i].first->tryActivate(controllers, context, CacheContext(id, rect, *(itemControllersInfo[i].second), visibleRect), cacheSpace);
 
         // if CacheCellEx was invalidated during TryActivate -> stop activate controllers
-        if (!m_cacheView)
+        if (m_cacheViews.isEmpty())
         {
             qDebug("TryActivateControllers break\n");
             break;
@@ -202,11 +210,11 @@ void CacheItem::tryActivateControllers(const ControllerContext& context, const C
 bool CacheItem::tooltipByPoint(const QPoint& point, TooltipInfo &tooltipInfo) const
 {
     // don't handle if CacheCellEx is not ready yet
-    if (!m_isCacheViewValid || !m_cacheView)
+    if (!m_isCacheViewValid || m_cacheViews.isEmpty())
         return false;
 
     bool success = false;
-    m_cacheView->forEachCacheView([&success, &point, &tooltipInfo, this](const CacheView2* cacheView)->bool {
+    cacheView()->forEachCacheView([&success, &point, &tooltipInfo, this](const CacheView2* cacheView)->bool {
         // skip views not under the point
         if (!cacheView->rect().contains(point))
             return true;
@@ -241,7 +249,7 @@ void CacheItem::validateCacheView(const GuiContext& ctx, const QRect* visibleRec
     if (m_isCacheViewValid)
         return;
 
-    Q_ASSERT(!m_cacheView);
+    Q_ASSERT(m_cacheViews.isEmpty());
 
     QRect* visibleItemRectPtr = nullptr;
 
@@ -258,12 +266,18 @@ void CacheItem::validateCacheView(const GuiContext& ctx, const QRect* visibleRec
 
     if (schema.isValid())
     {
-        QRect itemRect = rect;
-        QVector<CacheView2> cacheViews;
-        CacheView2* cacheView = schema.view->addCacheView(*schema.layout, ctx, id, cacheViews, itemRect, visibleItemRectPtr);
-        if (cacheView)
+        if (m_layouts && !visibleItemRectPtr)
+        {
+            // partly visible items are laid out individually
+            m_layouts->addCacheViews(schema, ctx, id, rect, m_cacheViews);
+        }
+        else
         {
-            m_cacheView.reset(new CacheView2(*cacheView));
+            QRect itemRect = rect;
+            CacheView2* cacheView = schema.view->addCacheView(*schema.layout, ctx, id, m_cacheViews, itemRect, visibleItemRectPtr);
+            if (!cacheView)
+                m_cacheViews.resize(0);
+            Q_ASSERT(!cacheView || cacheView == m_cacheViews.data());
         }
     }
 
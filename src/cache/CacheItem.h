@@ -26,6 +26,7 @@ namespace Qi
 class ControllerMouse;
 class ControllerContext;
 class CacheSpace;
+class CacheItemLayouts;
 struct TooltipInfo;
 
 class QI_EXPORT CacheItemInfo
@@ -48,10 +49,16 @@ public:
     CacheItem(const CacheItem& other);
     CacheItem& operator=(const CacheItem& other);
 
-    const CacheView2* cacheView() const { return m_cacheView.data(); }
-    CacheView2* cacheView() { return m_cacheView.data(); }
+    // reinitializes recycled item
+    void reset(const CacheItemInfo& info);
+
+    // root of the item views tree
+    const CacheView2* cacheView() const { return m_cacheViews.isEmpty() ? nullptr : m_cacheViews.data(); }
+    CacheView2* cacheView() { return m_cacheViews.isEmpty() ? nullptr : m_cacheViews.data(); }
 
     bool isCacheViewValid() const { return m_isCacheViewValid; }
+    // memoized layouts shared with other items
+    void setLayouts(CacheItemLayouts* layouts) { m_layouts = layouts; }
     const CacheView2* findCacheViewByController(const ControllerMouse* controller) const;
 
     void invalidateCacheView();
@@ -70,8 +77,10 @@ public:
 
 
 private:
-    SharedPtr<CacheView2> m_cacheView;
+    // item views tree in pre-order, the array is reused between validations
+    QVector<CacheView2> m_cacheViews;
     bool m_isCacheViewValid;
+    CacheItemLayouts* m_layouts;
 };
 
 } // end namespace Qi
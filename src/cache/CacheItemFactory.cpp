@@ -18,6 +18,8 @@
 #include "core/ext/Layouts.h"
 #include "core/ext/ViewComposite.h"
 #include "space/grid/GridID.h"
+#include <algorithm>
+#include <limits>
 
 namespace Qi
 {
@@ -62,17 +64,32 @@ ViewSchema CacheItemFactory::createViewSchema(ID absId) const
         }
     }
 
+    return createViewSchema(viewSchemas);
+}
+
+ViewSchema CacheItemFactory::createViewSchema(const QVector<ViewSchema>& viewSchemas) const
+{
     if (viewSchemas.empty())
         return ViewSchema();
     else if (viewSchemas.size() == 1)
         return viewSchemas.front();
-    else
+
+    std::vector<const void*> key;
+    key.reserve(2 * viewSchemas.size());
+    for (const auto& viewSchema : viewSchemas)
+    {
+        key.push_back(viewSchema.layout.data());
+        key.push_back(viewSchema.view.data());
+    }
+
+    ViewSchema& schema = m_compositeSchemas[key];
+    if (!schema.isValid())
     {
-        ViewSchema schema;
         schema.layout = makeLayoutBackground();
         schema.view = makeShared<ViewComposite>(viewSchemas);
-        return schema;
     }
+
+    return schema;
 }
 
 SharedPtr<CacheItemFactory> createCacheItemFactoryDefault(const Space& space)
@@ -111,6 +128,142 @@ SharedPtr<CacheItemFactory> createCacheItemFactoryItem(const Space& space)
     return makeShared<CacheItemFactoryItem>(space);
 }
 
+// schemas masks for consecutive lines segments
+class SchemasByLines
+{
+public:
+    void build(const QVector<IntervalSet>& schemasLines)
+    {
+        // all lines of a segment share the same schemas
+        QVector<int> boundaries;
+        boundaries.append(std::numeric_limits<int>::min());
+        for (const auto& lines : schemasLines)
+        {
+            for (const auto& interval : lines.intervals())
+            {
+                boundaries.append(interval.begin);
+                boundaries.append(interval.end);
+            }
+        }
+        std::sort(boundaries.begin(), boundaries.end());
+        boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+        m_begins.clear();
+        m_masks.clear();
+        for (int boundary : boundaries)
+        {
+            quint64 mask = 0;
+            for (int i = 0; i < schemasLines.size(); ++i)
+            {
+                if (schemasLines[i].contains(boundary))
+                    mask |= quint64(1) << i;
+            }
+
+            if (!m_masks.isEmpty() && m_masks.last() == mask)
+                continue;
+
+            m_begins.append(boundary);
+            m_masks.append(mask);
+        }
+    }
+
+    quint64 mask(int line) const
+    {
+        auto it = std::upper_bound(m_begins.begin(), m_begins.end(), line);
+        Q_ASSERT(it != m_begins.begin());
+        return m_masks[int(it - m_begins.begin()) - 1];
+    }
+
+private:
+    QVector<int> m_begins;
+    QVector<quint64> m_masks;
+};
+
+class CacheItemFactoryGrid: public CacheItemFactory
+{
+public:
+    CacheItemFactoryGrid(const Space& space)
+        : CacheItemFactory(space)
+    {
+        // space recreates factory on any schemas or ranges change
+        const auto& schemas = space.schemasOrdered();
+        m_isPrecompiled = schemas.size() <= MaxSchemas;
+        if (!m_isPrecompiled)
+            return;
+
+        QVector<IntervalSet> schemasRows(schemas.size());
+        QVector<IntervalSet> schemasColumns(schemas.size());
+        for (int i = 0; i < schemas.size(); ++i)
+        {
+            if (!schemas[i].range->gridStructure(schemasRows[i], schemasColumns[i]))
+            {
+                // should call Range::hasItem for such schemas
+                m_dynamicMask |= quint64(1) << i;
+                schemasRows[i].clear();
+                schemasColumns[i].clear();
+            }
+        }
+
+        m_rows.build(schemasRows);
+        m_columns.build(schemasColumns);
+    }
+
+protected:
+    void initSchemaImpl(CacheItemInfo& info) const override
+    {
+        if (!m_isPrecompiled)
+        {
+            CacheItemFactory::initSchemaImpl(info);
+            return;
+        }
+
+        const auto& id = info.id.as<GridID>();
+        quint64 mask = m_rows.mask(id.row) & m_columns.mask(id.column);
+
+        const auto& schemas = space().schemasOrdered();
+        if (m_dynamicMask)
+        {
+            for (int i = 0; i < schemas.size(); ++i)
+            {
+                quint64 bit = quint64(1) << i;
+                if ((m_dynamicMask & bit) && schemas[i].range->hasItem(info.id))
+                    mask |= bit;
+            }
+        }
+
+        auto it = m_schemaByMask.find(mask);
+        if (it != m_schemaByMask.end())
+        {
+            info.schema = it.value();
+            return;
+        }
+
+        QVector<ViewSchema> viewSchemas;
+        for (int i = 0; i < schemas.size(); ++i)
+        {
+            if (mask & (quint64(1) << i))
+                viewSchemas.append(ViewSchema(schemas[i].layout, schemas[i].view));
+        }
+
+        info.schema = createViewSchema(viewSchemas);
+        m_schemaByMask.insert(mask, info.schema);
+    }
+
+private:
+    enum { MaxSchemas = 64 };
+
+    bool m_isPrecompiled = false;
+    quint64 m_dynamicMask = 0;
+    SchemasByLines m_rows;
+    SchemasByLines m_columns;
+    mutable QMap<quint64, ViewSchema> m_schemaByMask;
+};
+
+SharedPtr<CacheItemFactory> createCacheItemFactoryGrid(const Space& space)
+{
+    return makeShared<CacheItemFactoryGrid>(space);
+}
+
 class CacheItemFactorySameSchemaByColumn: public CacheItemFactory
 {
 public:
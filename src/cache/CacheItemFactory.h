@@ -19,6 +19,8 @@
 
 #include "space/Space.h"
 #include "CacheItem.h"
+#include <map>
+#include <vector>
 
 namespace Qi
 {
@@ -40,13 +42,18 @@ protected:
     virtual void initSchemaImpl(CacheItemInfo& info) const;
 
     ViewSchema createViewSchema(ID absId) const;
+    ViewSchema createViewSchema(const QVector<ViewSchema>& viewSchemas) const;
 
 private:
     const Space& m_space;
+    // composite schemas shared by all items with the same schemas combination
+    mutable std::map<std::vector<const void*>, ViewSchema> m_compositeSchemas;
 };
 
 QI_EXPORT SharedPtr<CacheItemFactory> createCacheItemFactoryDefault(const Space& space);
 QI_EXPORT SharedPtr<CacheItemFactory> createCacheItemFactoryItem(const Space& space);
+// resolves schemas of grid items using precompiled rows and columns tables
+QI_EXPORT SharedPtr<CacheItemFactory> createCacheItemFactoryGrid(const Space& space);
 QI_EXPORT SharedPtr<CacheItemFactory> createCacheItemFactorySameSchemaByColumn(const Space& space);
 QI_EXPORT SharedPtr<CacheItemFactory> createCacheItemFactorySameSchemaByRow(const Space& space);
 
@@ -0,0 +1,112 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "CacheItemLayouts.h"
+#include "core/View.h"
+#include "core/Layout.h"
+
+namespace Qi
+{
+
+// too many different item sizes make memoization useless
+static const int maxEntries = 1024;
+
+static CacheView2* addCacheViewsRaw(const ViewSchema& schema, const GuiContext& ctx, ID id, const QRect& itemRect, QVector<CacheView2>& cacheViews)
+{
+    QRect rect = itemRect;
+    return schema.view->addCacheView(*schema.layout, ctx, id, cacheViews, rect, nullptr);
+}
+
+bool CacheItemLayouts::Key::operator<(const Key& other) const
+{
+    if (view != other.view)
+        return view < other.view;
+    if (layout != other.layout)
+        return layout < other.layout;
+    if (size.width() != other.size.width())
+        return size.width() < other.size.width();
+    return size.height() < other.size.height();
+}
+
+CacheItemLayouts::CacheItemLayouts()
+{
+}
+
+CacheItemLayouts::~CacheItemLayouts()
+{
+}
+
+void CacheItemLayouts::clear()
+{
+    m_entries.clear();
+}
+
+bool CacheItemLayouts::addCacheViews(const ViewSchema& schema, const GuiContext& ctx, ID id, const QRect& itemRect, QVector<CacheView2>& cacheViews)
+{
+    Q_ASSERT(schema.isValid());
+    Q_ASSERT(cacheViews.isEmpty());
+
+    validateGuiContext(ctx);
+
+    Key key = { schema.view.data(), schema.layout.data(), itemRect.size() };
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        if (m_entries.size() >= maxEntries)
+            m_entries.clear();
+
+        Entry entry;
+        entry.isInvariant = schema.view->isLayoutInvariant(*schema.layout);
+        // lay out at the origin
+        if (entry.isInvariant && !addCacheViewsRaw(schema, ctx, id, QRect(QPoint(0, 0), itemRect.size()), entry.cacheViews))
+            entry.cacheViews.clear();
+
+        it = m_entries.emplace(key, std::move(entry)).first;
+    }
+
+    const Entry& entry = it->second;
+    if (!entry.isInvariant)
+        return addCacheViewsRaw(schema, ctx, id, itemRect, cacheViews);
+
+    // copy memoized views into the item
+    QPoint offset = itemRect.topLeft();
+    for (const auto& cacheView : entry.cacheViews)
+    {
+        cacheViews.append(cacheView);
+        cacheViews.last().rRect().translate(offset);
+    }
+
+    return !cacheViews.isEmpty();
+}
+
+void CacheItemLayouts::validateGuiContext(const GuiContext& ctx)
+{
+    const QStyle* style = ctx.style();
+    const QFont& font = ctx.widget->font();
+
+    if (m_widget == ctx.widget && m_style == style && m_font == font)
+        return;
+
+    m_widget = ctx.widget;
+    m_style = style;
+    m_font = font;
+
+    // all layouts are done with old gui state
+    clear();
+}
+
+} // end namespace Qi
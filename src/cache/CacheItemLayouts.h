@@ -0,0 +1,77 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef QI_CACHE_ITEM_LAYOUTS_H
+#define QI_CACHE_ITEM_LAYOUTS_H
+
+#include "CacheView.h"
+#include "core/ItemSchema.h"
+#include <QFont>
+#include <map>
+
+class QStyle;
+class QWidget;
+
+namespace Qi
+{
+
+// memoized cache views of items sharing the schema and the size
+// relative view rectangles are laid out once and translated per item
+class QI_EXPORT CacheItemLayouts
+{
+    Q_DISABLE_COPY(CacheItemLayouts)
+
+public:
+    CacheItemLayouts();
+    ~CacheItemLayouts();
+
+    void clear();
+
+    // fills cacheViews for the item, returns false if nothing is visible
+    bool addCacheViews(const ViewSchema& schema, const GuiContext& ctx, ID id, const QRect& itemRect, QVector<CacheView2>& cacheViews);
+
+private:
+    struct Key
+    {
+        const View* view;
+        const Layout* layout;
+        QSize size;
+
+        bool operator<(const Key& other) const;
+    };
+
+    struct Entry
+    {
+        // layout depends on item rect only
+        bool isInvariant = false;
+        // cache views relative to item top left corner
+        QVector<CacheView2> cacheViews;
+    };
+
+    void validateGuiContext(const GuiContext& ctx);
+
+    std::map<Key, Entry> m_entries;
+
+    // gui state layouts depend on
+    const QWidget* m_widget = nullptr;
+    const QStyle* m_style = nullptr;
+    QFont m_font;
+};
+
+} // end namespace Qi
+
+#endif // QI_CACHE_ITEM_LAYOUTS_H
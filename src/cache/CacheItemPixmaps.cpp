@@ -0,0 +1,184 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "CacheItemPixmaps.h"
+#include "CacheItem.h"
+#include "core/misc/ViewAuxiliary.h"
+#include <QPainter>
+#include <QtMath>
+
+namespace Qi
+{
+
+static qint64 pixmapBytes(const QPixmap& pixmap)
+{
+    return qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+}
+
+CacheItemPixmaps::CacheItemPixmaps(qint64 byteBudget)
+    : m_byteBudget(byteBudget)
+{
+    Q_ASSERT(m_byteBudget >= 0);
+}
+
+CacheItemPixmaps::~CacheItemPixmaps()
+{
+}
+
+void CacheItemPixmaps::setByteBudget(qint64 byteBudget)
+{
+    Q_ASSERT(byteBudget >= 0);
+    m_byteBudget = byteBudget;
+    shrink(m_byteBudget);
+}
+
+void CacheItemPixmaps::invalidate()
+{
+    ++m_contentVersion;
+    m_pixmaps.clear();
+    m_lru.clear();
+    m_bytes = 0;
+}
+
+void CacheItemPixmaps::invalidate(const ChangedItems& items)
+{
+    for (auto it = m_pixmaps.begin(); it != m_pixmaps.end(); )
+    {
+        if (items.hasItem(it.key()))
+        {
+            m_bytes -= pixmapBytes(it.value().pixmap);
+            m_lru.erase(it.value().lruIt);
+            it = m_pixmaps.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+bool CacheItemPixmaps::draw(CacheItem& cacheItem, QPainter* painter, const GuiContext& ctx, const QRect* visibleRect)
+{
+    // custom drawing cannot be cached
+    if (cacheItem.drawProxy)
+        return false;
+
+    const QRect& rect = cacheItem.rect;
+    if (rect.isEmpty())
+        return false;
+
+    // partly visible items are laid out against visible part
+    if (visibleRect && !visibleRect->contains(rect))
+        return false;
+
+    qreal devicePixelRatio = painter->device()->devicePixelRatioF();
+    qint64 bytes = qint64(qCeil(rect.width() * devicePixelRatio)) * qCeil(rect.height() * devicePixelRatio) * 4;
+    if (bytes > m_byteBudget)
+        return false;
+
+    validateGuiContext(painter, ctx);
+
+    auto it = m_pixmaps.find(cacheItem.id);
+    if (it != m_pixmaps.end())
+    {
+        Entry& entry = it.value();
+        if (entry.size == rect.size() && entry.devicePixelRatio == devicePixelRatio && entry.contentVersion == m_contentVersion)
+        {
+            // views are still required by controllers and tooltips
+            cacheItem.validateCacheView(ctx, visibleRect);
+
+            // mark as recently used
+            m_lru.splice(m_lru.begin(), m_lru, entry.lruIt);
+            painter->drawPixmap(rect.topLeft(), entry.pixmap);
+            return true;
+        }
+
+        // pixmap is out of date
+        remove(it);
+    }
+
+    Entry entry;
+    entry.pixmap = render(cacheItem, painter, ctx, visibleRect, devicePixelRatio);
+    entry.size = rect.size();
+    entry.devicePixelRatio = devicePixelRatio;
+    entry.contentVersion = m_contentVersion;
+    entry.lruIt = m_lru.insert(m_lru.begin(), cacheItem.id);
+
+    painter->drawPixmap(rect.topLeft(), entry.pixmap);
+
+    m_bytes += pixmapBytes(entry.pixmap);
+    m_pixmaps.insert(cacheItem.id, entry);
+    shrink(m_byteBudget);
+
+    return true;
+}
+
+void CacheItemPixmaps::validateGuiContext(const QPainter* painter, const GuiContext& ctx)
+{
+    const QStyle* style = ctx.style();
+    qint64 paletteKey = ctx.palette().cacheKey();
+    QPalette::ColorGroup colorGroup = ctx.colorGroup();
+    const QFont& font = painter->font();
+
+    if (m_style == style && m_paletteKey == paletteKey && m_colorGroup == colorGroup && m_font == font)
+        return;
+
+    m_style = style;
+    m_paletteKey = paletteKey;
+    m_colorGroup = colorGroup;
+    m_font = font;
+
+    // all pixmaps are rendered with old gui state
+    invalidate();
+}
+
+QPixmap CacheItemPixmaps::render(CacheItem& cacheItem, QPainter* painter, const GuiContext& ctx, const QRect* visibleRect, qreal devicePixelRatio) const
+{
+    const QRect& rect = cacheItem.rect;
+
+    QPixmap pixmap(qCeil(rect.width() * devicePixelRatio), qCeil(rect.height() * devicePixelRatio));
+    pixmap.setDevicePixelRatio(devicePixelRatio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter pixmapPainter(&pixmap);
+    // inherit painter state of the widget
+    pixmapPainter.setFont(painter->font());
+    pixmapPainter.setPen(painter->pen());
+    pixmapPainter.setBrush(painter->brush());
+    pixmapPainter.setRenderHints(painter->renderHints());
+    pixmapPainter.setLayoutDirection(painter->layoutDirection());
+    // cache views are in window coordinates
+    pixmapPainter.translate(-rect.topLeft());
+
+    cacheItem.drawRaw(&pixmapPainter, ctx, visibleRect);
+
+    return pixmap;
+}
+
+void CacheItemPixmaps::remove(QHash<ID, Entry>::iterator it)
+{
+    m_bytes -= pixmapBytes(it.value().pixmap);
+    m_lru.erase(it.value().lruIt);
+    m_pixmaps.erase(it);
+}
+
+void CacheItemPixmaps::shrink(qint64 byteBudget)
+{
+    // evict least recently used pixmaps
+    while (m_bytes > byteBudget && !m_lru.empty())
+        remove(m_pixmaps.find(m_lru.back()));
+}
+
+} // end namespace Qi
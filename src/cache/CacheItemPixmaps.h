@@ -0,0 +1,96 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef QI_CACHE_ITEM_PIXMAPS_H
+#define QI_CACHE_ITEM_PIXMAPS_H
+
+#include "core/Range.h"
+#include <QPixmap>
+#include <QPalette>
+#include <QFont>
+#include <list>
+
+class QPainter;
+class QStyle;
+
+namespace Qi
+{
+
+class GuiContext;
+class CacheItem;
+
+// rendered pixmaps of cache items
+// pixmaps are keyed by item id and validated by item size,
+// device pixel ratio and content version.
+// memory is bounded by byte budget, least recently used pixmaps are evicted first
+class QI_EXPORT CacheItemPixmaps
+{
+    Q_DISABLE_COPY(CacheItemPixmaps)
+
+public:
+    explicit CacheItemPixmaps(qint64 byteBudget);
+    ~CacheItemPixmaps();
+
+    qint64 byteBudget() const { return m_byteBudget; }
+    void setByteBudget(qint64 byteBudget);
+    qint64 bytes() const { return m_bytes; }
+    int count() const { return m_pixmaps.size(); }
+
+    quint64 contentVersion() const { return m_contentVersion; }
+
+    // drops all pixmaps and advances content version
+    void invalidate();
+    // drops pixmaps of the changed items
+    void invalidate(const ChangedItems& items);
+
+    // draws cache item through its pixmap, renders pixmap if needed
+    // returns false if item cannot be cached
+    bool draw(CacheItem& cacheItem, QPainter* painter, const GuiContext& ctx, const QRect* visibleRect);
+
+private:
+    struct Entry
+    {
+        QPixmap pixmap;
+        QSize size;
+        qreal devicePixelRatio = 1.;
+        quint64 contentVersion = 0;
+        std::list<ID>::iterator lruIt;
+    };
+
+    void validateGuiContext(const QPainter* painter, const GuiContext& ctx);
+    QPixmap render(CacheItem& cacheItem, QPainter* painter, const GuiContext& ctx, const QRect* visibleRect, qreal devicePixelRatio) const;
+    void remove(QHash<ID, Entry>::iterator it);
+    void shrink(qint64 byteBudget);
+
+    qint64 m_byteBudget;
+    qint64 m_bytes = 0;
+    quint64 m_contentVersion = 0;
+
+    QHash<ID, Entry> m_pixmaps;
+    // most recently used ids are in front
+    std::list<ID> m_lru;
+
+    // gui state rendered pixmaps depend on
+    const QStyle* m_style = nullptr;
+    qint64 m_paletteKey = 0;
+    QPalette::ColorGroup m_colorGroup = QPalette::Active;
+    QFont m_font;
+};
+
+} // end namespace Qi
+
+#endif // QI_CACHE_ITEM_PIXMAPS_H
@@ -25,7 +25,8 @@ namespace Qi
 
 CacheView2::CacheView2()
     : m_view(nullptr),
-      m_showTooltip(false)
+      m_showTooltip(false),
+      m_descendantsCount(0)
 {
     // this constructor is required for QVector
     Q_ASSERT(false);
@@ -34,7 +35,8 @@ CacheView2::CacheView2()
 CacheView2::CacheView2(const View *view, const QRect &rect)
     : m_view(view),
       m_rect(rect),
-      m_showTooltip(false)
+      m_showTooltip(false),
+      m_descendantsCount(0)
 {
     Q_ASSERT(m_view);
 }
@@ -43,7 +45,7 @@ CacheView2::CacheView2(const CacheView2& other)
     : m_view(other.m_view),
       m_rect(other.m_rect),
       m_showTooltip(other.m_showTooltip),
-      m_subViews(other.m_subViews)
+      m_descendantsCount(other.m_descendantsCount)
 {
 }
 
@@ -56,7 +58,7 @@ CacheView2& CacheView2::operator=(const CacheView2& other)
     m_view =other.m_view;
     m_rect = other.m_rect;
     m_showTooltip = other.m_showTooltip;
-    m_subViews= other.m_subViews;
+    m_descendantsCount = other.m_descendantsCount;
     return *this;
 }
 
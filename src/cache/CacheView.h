@@ -27,7 +27,41 @@ namespace Qi
 
 class View;
 class GuiContext;
+class CacheView2;
 
+// range of direct sub views of a CacheView2
+class QI_EXPORT CacheSubViews
+{
+public:
+    class ConstIterator
+    {
+    public:
+        explicit ConstIterator(const CacheView2* cacheView): m_cacheView(cacheView) {}
+
+        const CacheView2& operator*() const { return *m_cacheView; }
+        const CacheView2* operator->() const { return m_cacheView; }
+        ConstIterator& operator++();
+
+        bool operator==(const ConstIterator& other) const { return m_cacheView == other.m_cacheView; }
+        bool operator!=(const ConstIterator& other) const { return m_cacheView != other.m_cacheView; }
+
+    private:
+        const CacheView2* m_cacheView;
+    };
+
+    CacheSubViews(const CacheView2* begin, const CacheView2* end): m_begin(begin), m_end(end) {}
+
+    ConstIterator begin() const { return ConstIterator(m_begin); }
+    ConstIterator end() const { return ConstIterator(m_end); }
+    bool isEmpty() const { return m_begin == m_end; }
+
+private:
+    const CacheView2* m_begin;
+    const CacheView2* m_end;
+};
+
+// cache views of an item are stored in one contiguous array in pre-order:
+// every view is followed by its descendants
 class QI_EXPORT CacheView2
 {
 public:
@@ -40,11 +74,14 @@ public:
 
     const View* view() const { return m_view; }
     const QRect& rect() const { return m_rect; }
-    const QVector<CacheView2>& subViews() const { return m_subViews; }
+    CacheSubViews subViews() const { return CacheSubViews(this + 1, this + 1 + m_descendantsCount); }
 
-    QVector<CacheView2>& rSubViews() { return m_subViews; }
     QRect& rRect() { return m_rect; }
 
+    // number of views stored after this one within its subtree
+    int descendantsCount() const { return m_descendantsCount; }
+    void setDescendantsCount(int descendantsCount) { m_descendantsCount = descendantsCount; }
+
     std::function<void(const CacheView2*, QPainter*, const GuiContext&, ID, const QRect&, const QRect*)> drawProxy;
 
     // draws view within m_rect
@@ -56,15 +93,13 @@ public:
     // retruns tooltip text
     bool tooltipText(ID id, QString& tooltipText) const;
 
+    // visits the view and its descendants in pre-order
     template <typename Pred>
     bool forEachCacheView(Pred pred)
     {
-        if (!pred(this))
-            return false;
-
-        for (auto& cacheSubView: m_subViews)
+        for (CacheView2* cacheView = this, *end = this + 1 + m_descendantsCount; cacheView != end; ++cacheView)
         {
-            if (!cacheSubView.forEachCacheView(pred))
+            if (!pred(cacheView))
                 return false;
         }
 
@@ -74,12 +109,9 @@ public:
     template <typename Pred>
     bool forEachCacheView(Pred pred) const
     {
-        if (!pred(this))
-            return false;
-
-        for (const auto& cacheSubView: m_subViews)
+        for (const CacheView2* cacheView = this, *end = this + 1 + m_descendantsCount; cacheView != end; ++cacheView)
         {
-            if (!cacheSubView.forEachCacheView(pred))
+            if (!pred(cacheView))
                 return false;
         }
 
@@ -91,9 +123,16 @@ protected:
     QRect m_rect;
     mutable bool m_showTooltip;
 
-    QVector<CacheView2> m_subViews;
+    int m_descendantsCount;
 };
 
+inline CacheSubViews::ConstIterator& CacheSubViews::ConstIterator::operator++()
+{
+    // skip descendants of the current sub view
+    m_cacheView += m_cacheView->descendantsCount() + 1;
+    return *this;
+}
+
 class QI_EXPORT CacheContext
 {
 public:
@@ -18,6 +18,7 @@
 #define QI_ITEM_ID_H
 
 #include "QiAPI.h"
+#include <QHash>
 #include <array>
 #include <memory>
 
@@ -133,6 +134,12 @@ public:
         return m_data != other.m_data;
     }
 
+    // QHash/QSet support
+    friend uint qHash(const ID& id, uint seed = 0)
+    {
+        return qHashBits(id.m_data.data(), sizeof(id.m_data), seed);
+    }
+
 protected:
     template <typename T>
     void CheckType() const
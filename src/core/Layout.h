@@ -49,6 +49,8 @@ public:
     void expandSize(const View& view, const GuiContext& ctx, ID id, ViewSizeMode sizeMode, QSize& size) const;
     // is final (eats all available item space)
     bool isFinal() const;
+    // does layout depend on view size
+    bool isViewSizeUsed() const { return isViewSizeUsedImpl(); }
 
     LayoutBehaviorMask behavior() const { return m_behavior; }
     bool isTransparent() const { return m_behavior&LayoutBehaviorTransparent; }
@@ -94,6 +96,8 @@ protected:
     virtual void expandSizeImpl(const ViewInfo& viewInfo, QSize& size) const = 0;
     // is final
     virtual bool isFinalImpl() const { return false; }
+    // does layout depend on view size
+    virtual bool isViewSizeUsedImpl() const { return true; }
 
 private:
     LayoutBehaviorMask m_behavior;
@@ -37,4 +37,33 @@ ModelComparable::~ModelComparable()
 
 }
 
+class SortKeysByModel: public SortKeys
+{
+public:
+    SortKeysByModel(const ModelComparable& model, const std::function<ID(int)>& lineToId)
+        : m_model(model),
+          m_lineToId(lineToId)
+    {}
+
+protected:
+    int compareImpl(int leftLine, int rightLine) const override
+    {
+        return m_model.compare(m_lineToId(leftLine), m_lineToId(rightLine));
+    }
+
+    bool isReadThreadSafeImpl() const override
+    {
+        return m_model.isReadThreadSafe();
+    }
+
+private:
+    const ModelComparable& m_model;
+    std::function<ID(int)> m_lineToId;
+};
+
+UniquePtr<SortKeys> ModelComparable::sortKeysImpl(int /*linesCount*/, const std::function<ID(int)>& lineToId) const
+{
+    return makeUnique<SortKeysByModel>(*this, lineToId);
+}
+
 } // end namespace Qi
@@ -17,7 +17,8 @@
 #ifndef QI_MODEL_H
 #define QI_MODEL_H
 
-#include "ID.h"
+#include "Range.h"
+#include <functional>
 
 namespace Qi
 {
@@ -32,9 +33,35 @@ protected:
 
 public:
     virtual ~Model();
+
+    // model values can be read from several threads simultaneously
+    // (while nobody modifies the model)
+    bool isReadThreadSafe() const { return isReadThreadSafeImpl(); }
     
 signals:
-    void modelChanged(const Model*);
+    // items describe changed items if they are known
+    void modelChanged(const Model*, const ChangedItems& items = ChangedItems());
+
+protected:
+    virtual bool isReadThreadSafeImpl() const { return false; }
+};
+
+// keys extracted from a model to compare lines without model lookups
+class QI_EXPORT SortKeys
+{
+    Q_DISABLE_COPY(SortKeys)
+
+public:
+    SortKeys() = default;
+    virtual ~SortKeys() = default;
+
+    int compare(int leftLine, int rightLine) const { return compareImpl(leftLine, rightLine); }
+    // keys can be compared from several threads simultaneously
+    bool isReadThreadSafe() const { return isReadThreadSafeImpl(); }
+
+protected:
+    virtual int compareImpl(int leftLine, int rightLine) const = 0;
+    virtual bool isReadThreadSafeImpl() const { return true; }
 };
 
 class QI_EXPORT ModelComparable: public Model
@@ -55,9 +82,16 @@ public:
 
     bool isAscendingDefault(ID item) const { return isAscendingDefaultImpl(item); }
 
+    // extracts keys for lines [0, linesCount), lineToId maps line to item
+    // keys->compare(left, right) gives the same result as compare(lineToId(left), lineToId(right))
+    UniquePtr<SortKeys> sortKeys(int linesCount, const std::function<ID(int)>& lineToId) const { return sortKeysImpl(linesCount, lineToId); }
+
 protected:
     virtual int compareImpl(ID left, ID right) const = 0;
     virtual bool isAscendingDefaultImpl(ID /*item*/) const { return true; }
+    // default keys call compareImpl for every comparison
+    // models that override compareImpl should override sortKeysImpl consistently
+    virtual UniquePtr<SortKeys> sortKeysImpl(int linesCount, const std::function<ID(int)>& lineToId) const;
 };
 
 } // end namespace Qi
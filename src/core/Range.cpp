@@ -19,4 +19,15 @@
 namespace Qi
 {
 
+bool ChangedItems::hasItem(ID id) const
+{
+    if (isAll())
+        return true;
+
+    if (!range.isNull() && range->hasItem(id))
+        return true;
+
+    return ids.contains(id);
+}
+
 } // end namespace Qi
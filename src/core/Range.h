@@ -18,7 +18,9 @@
 #define QI_RANGE_H
 
 #include <QObject>
+#include <QVector>
 #include "ID.h"
+#include "utils/IntervalSet.h"
 
 namespace Qi
 {
@@ -32,6 +34,9 @@ public:
     virtual ~Range() = default;
 
     bool hasItem(ID id) const { return hasItemImpl(id); }
+    // describes grid range as product of rows and columns
+    // returns false if range has no such structure
+    bool gridStructure(IntervalSet& rows, IntervalSet& columns) const { return gridStructureImpl(rows, columns); }
 
 signals:
     void rangeChanged(const Range*, ChangeReason);
@@ -41,6 +46,24 @@ protected:
 
     // should return true if item is included in the range and false otherwise
     virtual bool hasItemImpl(ID id) const = 0;
+    virtual bool gridStructureImpl(IntervalSet& /*rows*/, IntervalSet& /*columns*/) const { return false; }
+};
+
+// describes items affected by a change
+// list of items and/or range of items, empty ChangedItems means all items
+class QI_EXPORT ChangedItems
+{
+public:
+    ChangedItems() = default;
+    explicit ChangedItems(ID id) { ids.append(id); }
+    explicit ChangedItems(QVector<ID> ids): ids(std::move(ids)) {}
+    explicit ChangedItems(SharedPtr<Range> range): range(std::move(range)) {}
+
+    bool isAll() const { return ids.isEmpty() && range.isNull(); }
+    bool hasItem(ID id) const;
+
+    QVector<ID> ids;
+    SharedPtr<Range> range;
 };
 
 } // end namespace Qi
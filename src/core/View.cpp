@@ -77,9 +77,9 @@ bool View::tooltipText(ID id, QString& text) const
     return tooltipTextImpl(id, text);
 }
 
-void View::emitViewChanged(ChangeReason reason)
+void View::emitViewChanged(ChangeReason reason, const ChangedItems& items)
 {
-    emit viewChanged(this, reason);
+    emit viewChanged(this, reason, items);
 }
 
 void View::addViewImpl(ID /*id*/, QVector<const View*>& views) const
@@ -98,6 +98,11 @@ CacheView2* View::addCacheViewImpl(const Layout& layout, const GuiContext& ctx,
     return &cacheViews.back();
 }
 
+bool View::isLayoutInvariantImpl(const Layout& layout) const
+{
+    return !layout.isViewSizeUsed() || isSizeInvariant();
+}
+
 SharedPtr<CacheView> View::createCacheViewImpl(const CacheView* parent, QRect rect, ID id, const GuiContext& ctx) const
 {
     return nullptr;
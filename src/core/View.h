@@ -17,6 +17,7 @@
 #ifndef QI_VIEW_H
 #define QI_VIEW_H
 
+#include "core/Range.h"
 #include "core/misc/ViewAuxiliary.h"
 #include "cache/CacheView.h"
 #include <QPainter>
@@ -59,6 +60,10 @@ public:
     // returns size of the view
     QSize size(const GuiContext& ctx, ID id, ViewSizeMode sizeMode) const
     { return sizeImpl(ctx, id, sizeMode); }
+    // returns true if size of the view doesn't depend on item id
+    bool isSizeInvariant() const { return isSizeInvariantImpl(); }
+    // returns true if cache views added with the layout depend on item rect only
+    bool isLayoutInvariant(const Layout& layout) const { return isLayoutInvariantImpl(layout); }
 
     // draws view content
     void draw(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const;
@@ -78,10 +83,11 @@ public:
     Model* model() { return modelImpl(); }
 
     // emits viewChanged signal
-    void emitViewChanged(ChangeReason reason);
+    void emitViewChanged(ChangeReason reason, const ChangedItems& items = ChangedItems());
 
 signals:
-    void viewChanged(const View*, ChangeReason);
+    // items describe changed items if they are known
+    void viewChanged(const View*, ChangeReason, const ChangedItems& items = ChangedItems());
 
 protected:
     // adds View to views
@@ -92,6 +98,8 @@ protected:
     virtual SharedPtr<CacheView> createCacheViewImpl(const CacheView* parent, QRect rect, ID id, const GuiContext& ctx) const;
     // returns size of the view
     virtual QSize sizeImpl(const GuiContext& /*ctx*/, ID /*id*/, ViewSizeMode /*sizeMode*/) const;
+    virtual bool isSizeInvariantImpl() const { return false; }
+    virtual bool isLayoutInvariantImpl(const Layout& layout) const;
     // draws view content
     virtual void drawImpl(QPainter* /*painter*/, const GuiContext& /*ctx*/, const CacheContext& /*cache*/, bool* /*showTooltip*/) const { }
     // cleanups drawing attributes
@@ -133,6 +133,7 @@ void PushableTracker::onViewChanged(const View* view, ChangeReason changeReason)
     {
         QObject::disconnect(m_controllerConnection);
         m_controller = nullptr;
+        m_hasPushedId = false;
 
         auto controllerPushable = view->controller().objectCast<ControllerMousePushable>();
         if (controllerPushable)
@@ -149,7 +150,24 @@ void PushableTracker::onPushStateChanged(const ControllerMousePushable* controll
 {
     Q_UNUSED(controllerPushable);
     Q_ASSERT(controllerPushable == m_controller.data());
-    m_owner->emitViewChanged(ChangeReasonViewContent);
+
+    // only previously and currently pushed items are changed
+    QVector<ID> ids;
+    if (m_hasPushedId)
+        ids.append(m_pushedId);
+
+    const ID* activeId = m_controller->activeId();
+    m_hasPushedId = activeId && (m_controller->pushState() != MousePushStateNone);
+    if (m_hasPushedId)
+    {
+        if (ids.isEmpty() || ids.first() != *activeId)
+            ids.append(*activeId);
+        m_pushedId = *activeId;
+    }
+
+    // empty ChangedItems means all items
+    if (!ids.isEmpty())
+        m_owner->emitViewChanged(ChangeReasonViewContent, ChangedItems(std::move(ids)));
 }
 
 
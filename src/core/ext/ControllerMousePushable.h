@@ -81,6 +81,10 @@ private:
 
     QPointer<ControllerMousePushable> m_controller;
     QMetaObject::Connection m_controllerConnection;
+
+    // item drawn with non-default push state
+    ID m_pushedId;
+    bool m_hasPushedId = false;
 };
 
 } // end namespace Qi
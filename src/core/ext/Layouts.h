@@ -47,6 +47,7 @@ protected:
     bool doLayoutImpl(const ViewInfo& viewInfo, LayoutInfo& info) const override;
     void expandSizeImpl(const ViewInfo& viewInfo, QSize& size) const override;
     bool isFinalImpl() const override { return !isTransparent(); }
+    bool isViewSizeUsedImpl() const override { return false; }
 };
 
 class QI_EXPORT LayoutLeft : public LayoutHor
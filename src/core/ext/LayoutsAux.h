@@ -53,6 +53,7 @@ public:
 
 protected:
     void expandSizeImpl(const ViewInfo& viewInfo, QSize& size) const override;
+    bool isViewSizeUsedImpl() const override { return false; }
 };
 
 class QI_EXPORT LayoutSquareVer : public Layout
@@ -64,6 +65,7 @@ public:
 
 protected:
     void expandSizeImpl(const ViewInfo& viewInfo, QSize& size) const override;
+    bool isViewSizeUsedImpl() const override { return false; }
 };
 
 class QI_EXPORT LayoutFixedHor : public Layout
@@ -78,6 +80,7 @@ public:
 
 protected:
     void expandSizeImpl(const ViewInfo& viewInfo, QSize& size) const override;
+    bool isViewSizeUsedImpl() const override { return false; }
 
     int m_width;
 };
@@ -94,6 +97,7 @@ public:
 
 protected:
     void expandSizeImpl(const ViewInfo& viewInfo, QSize& size) const override;
+    bool isViewSizeUsedImpl() const override { return false; }
 
     int m_height;
 };
@@ -46,6 +46,14 @@ protected:
             return ModelTyped<Target_t>::compareImpl(left, right);
     }
 
+    UniquePtr<SortKeys> sortKeysImpl(int linesCount, const std::function<ID(int)>& lineToId) const override
+    {
+        if (m_compareBySource)
+            return m_sourceModel->sortKeys(linesCount, lineToId);
+        else
+            return ModelTyped<Target_t>::sortKeysImpl(linesCount, lineToId);
+    }
+
     bool isAscendingDefaultImpl(ID id) const override
     {
         if (m_compareBySource)
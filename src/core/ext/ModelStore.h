@@ -47,6 +47,9 @@ public:
     }
 
 protected:
+    bool isReadThreadSafeImpl() const override { return true; }
+    bool isValuePerItemImpl() const override { return true; }
+
     T valueIdImpl(GridID id) const final
     {
         int index = id.column * m_rowsCount + id.row;
@@ -106,6 +109,8 @@ public:
     }
 
 protected:
+    bool isReadThreadSafeImpl() const override { return true; }
+
     T valueImpl(ID /*item*/) const override
     {
         return m_value;
@@ -143,6 +148,9 @@ public:
     }
 
 protected:
+    bool isReadThreadSafeImpl() const override { return true; }
+    bool isValuePerItemImpl() const override { return true; }
+
     T valueIdImpl(GridID id) const override
     {
         auto it = m_values.find(id.column);
@@ -255,6 +263,8 @@ public:
     }
 
 protected:
+    bool isReadThreadSafeImpl() const override { return true; }
+
     T valueIdImpl(GridID id) const override
     {
         if (id.row >= m_values.size())
@@ -329,6 +339,8 @@ public:
     }
 
 protected:
+    bool isReadThreadSafeImpl() const override { return true; }
+
     T valueIdImpl(GridID id) const override
     {
         if (id.column >= m_values.size())
@@ -399,6 +411,8 @@ public:
     }
 
 protected:
+    bool isReadThreadSafeImpl() const override { return true; }
+
     T valueImpl(ID id) const override
     {
         auto index = m_convertID(id);
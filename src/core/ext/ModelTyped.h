@@ -19,6 +19,7 @@
 
 #include "core/Model.h"
 #include "core/ItemsIterator.h"
+#include <QVector>
 
 namespace Qi
 {
@@ -37,6 +38,28 @@ namespace Private
     }
 }
 
+// keys stored by value in contiguous array
+template <typename Key>
+class SortKeysTyped: public SortKeys
+{
+public:
+    explicit SortKeysTyped(int linesCount)
+    {
+        m_keys.reserve(linesCount);
+    }
+
+    void append(const Key& key) { m_keys.append(key); }
+
+protected:
+    int compareImpl(int leftLine, int rightLine) const override
+    {
+        return Private::compareValues(m_keys[leftLine], m_keys[rightLine]);
+    }
+
+private:
+    QVector<Key> m_keys;
+};
+
 // typed Model - represents T values
 template <typename T>
 class ModelTyped : public ModelComparable
@@ -55,7 +78,7 @@ public:
     {
         if (setValueImpl(id, value))
         {
-            emit modelChanged(this);
+            emit modelChanged(this, changedItems(id));
             return true;
         }
         return false;
@@ -72,11 +95,25 @@ public:
     }
 
 protected:
+    // items affected by setValue(id)
+    ChangedItems changedItems(ID id) const { return isValuePerItemImpl() ? ChangedItems(id) : ChangedItems(); }
+
     int compareImpl(ID left, ID right) const override { return Private::compareValues(value(left), value(right)); }
     bool isAscendingDefaultImpl(ID /*item*/) const override { return m_ascendingDefault; }
+    UniquePtr<SortKeys> sortKeysImpl(int linesCount, const std::function<ID(int)>& lineToId) const override
+    {
+        // fetch every value once
+        auto keys = makeUnique<SortKeysTyped<typename std::decay<ValueType_t>::type>>(linesCount);
+        for (int line = 0; line < linesCount; ++line)
+            keys->append(value(lineToId(line)));
+        return std::move(keys);
+    }
 
     virtual ValueType_t valueImpl(ID id) const = 0;
     virtual bool setValueImpl(ID id, ValueType_t value) = 0;
+    // returns true if every item has its own value, so setValue changes that item only
+    // otherwise setValue reports all items as changed
+    virtual bool isValuePerItemImpl() const { return false; }
     virtual bool setValueMultipleImpl(IdIterator& it, ValueType_t value)
     {
         bool result = false;
@@ -103,7 +140,7 @@ public:
     {
         if (setValueIdImpl(id, value))
         {
-            emit modelChanged(this);
+            emit modelChanged(this, this->changedItems(ID(id)));
             return true;
         }
         return false;
@@ -21,7 +21,7 @@ namespace Qi
 
 RangeSelection& RangeSelection::operator=(const RangeSelection& other)
 {
-    m_ranges = other.m_ranges;
+    m_layers = other.m_layers;
     emit rangeChanged(this, ChangeReasonRange);
 
     return *this;
@@ -29,29 +29,105 @@ RangeSelection& RangeSelection::operator=(const RangeSelection& other)
 
 void RangeSelection::clear()
 {
-    m_ranges.clear();
+    m_layers.clear();
     emit rangeChanged(this, ChangeReasonRange);
 }
 
 void RangeSelection::addRange(SharedPtr<Range> range, bool exclude)
 {
-    RangeInfo info = { std::move(range), exclude };
-    m_ranges.append(info);
+    if (!addGridRange(*range, exclude))
+    {
+        Layer layer = { std::move(range), exclude, GridRegion(), GridRegion() };
+        m_layers.append(std::move(layer));
+    }
+
     emit rangeChanged(this, ChangeReasonRange);
 }
 
+bool RangeSelection::toRegion(GridRegion& region) const
+{
+    region.clear();
+
+    if (m_layers.isEmpty())
+        return true;
+
+    // grid ranges are always merged into single layer unless other ranges are in between
+    if (m_layers.size() > 1 || m_layers.first().range)
+        return false;
+
+    region = m_layers.first().selected;
+    return true;
+}
+
 bool RangeSelection::hasItemImpl(ID id) const
 {
-    bool excluded = true;
-    for (const auto& range: m_ranges)
+    // the last layer containing the item wins
+    for (int i = m_layers.size() - 1; i >= 0; --i)
     {
-        if (range.range->hasItem(id))
+        const auto& layer = m_layers[i];
+        if (layer.range)
         {
-            excluded = range.exclude;
+            if (layer.range->hasItem(id))
+                return !layer.exclude;
+        }
+        else
+        {
+            GridID gridId = id.as<GridID>();
+            if (layer.selected.contains(gridId))
+                return true;
+            if (layer.deselected.contains(gridId))
+                return false;
         }
     }
 
-    return !excluded;
+    return false;
+}
+
+bool RangeSelection::addGridRange(const Range& range, bool exclude)
+{
+    if (qobject_cast<const RangeAll*>(&range))
+    {
+        // overrides all previous ranges
+        m_layers.clear();
+        if (!exclude)
+            addGridCells(IntervalSet::all(), IntervalSet::all(), false);
+        return true;
+    }
+
+    IntervalSet rows, columns;
+    if (!range.gridStructure(rows, columns))
+        return false;
+
+    if (!rows.isEmpty() && !columns.isEmpty())
+        addGridCells(rows, columns, exclude);
+
+    return true;
+}
+
+void RangeSelection::addGridCells(const IntervalSet& rows, const IntervalSet& columns, bool exclude)
+{
+    if (m_layers.isEmpty() || m_layers.last().range)
+    {
+        Layer layer = { nullptr, false, GridRegion(), GridRegion() };
+        m_layers.append(std::move(layer));
+    }
+
+    auto& layer = m_layers.last();
+    // bottom layer has nothing to deselect
+    bool trackDeselected = m_layers.size() > 1;
+
+    if (exclude)
+    {
+        layer.selected.subtract(rows, columns);
+        if (trackDeselected)
+            layer.deselected.unite(rows, columns);
+    }
+    else
+    {
+        layer.selected.unite(rows, columns);
+        if (trackDeselected)
+            layer.deselected.subtract(rows, columns);
+    }
 }
 
 RangeNone::RangeNone()
@@ -63,6 +139,13 @@ bool RangeNone::hasItemImpl(ID /*id*/) const
     return false;
 }
 
+bool RangeNone::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows.clear();
+    columns.clear();
+    return true;
+}
+
 SharedPtr<RangeNone> makeRangeNone()
 {
     return makeShared<RangeNone>();
@@ -77,6 +160,13 @@ bool RangeAll::hasItemImpl(ID /*id*/) const
     return true;
 }
 
+bool RangeAll::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows = IntervalSet::all();
+    columns = IntervalSet::all();
+    return true;
+}
+
 SharedPtr<RangeAll> makeRangeAll()
 {
     return makeShared<RangeAll>();
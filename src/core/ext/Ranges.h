@@ -18,6 +18,7 @@
 #define QI_RANGES_H
 
 #include "core/Range.h"
+#include "space/grid/GridRegion.h"
 #include <QSet>
 #include <QVector>
 #include <functional>
@@ -41,6 +42,9 @@ protected:
     bool hasItemImpl(ID id) const override { return hasItemCallback ? hasItemCallback(id) : false; }
 };
 
+// ordered list of included and excluded ranges
+// grid ranges are compacted into cell regions so membership test
+// doesn't depend on selection history
 class QI_EXPORT RangeSelection: public Range
 {
     Q_OBJECT
@@ -51,21 +55,31 @@ public:
 
     RangeSelection& operator=(const RangeSelection& other);
 
-    bool isEmpty() const { return m_ranges.isEmpty(); }
+    bool isEmpty() const { return m_layers.isEmpty(); }
     void clear();
     void addRange(SharedPtr<Range> range, bool exclude);
 
+    // returns false if selection has non grid ranges and cannot be described by cells region
+    bool toRegion(GridRegion& region) const;
+
 protected:
     bool hasItemImpl(ID id) const override;
 
 private:
-    struct RangeInfo
+    bool addGridRange(const Range& range, bool exclude);
+    void addGridCells(const IntervalSet& rows, const IntervalSet& columns, bool exclude);
+
+    struct Layer
     {
+        // opaque range or null for compacted grid cells
         SharedPtr<Range> range;
         bool exclude;
+
+        GridRegion selected;
+        GridRegion deselected;
     };
 
-    QVector<RangeInfo> m_ranges;
+    QVector<Layer> m_layers;
 };
 
 class QI_EXPORT RangeNone: public Range
@@ -77,6 +91,7 @@ public:
     
 protected:
     bool hasItemImpl(ID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
 };
 QI_EXPORT SharedPtr<RangeNone> makeRangeNone();
 
@@ -89,6 +104,7 @@ public:
     
 protected:
     bool hasItemImpl(ID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
 };
 QI_EXPORT SharedPtr<RangeAll> makeRangeAll();
 
@@ -15,6 +15,7 @@
 */
 
 #include "ViewComposite.h"
+#include <QVarLengthArray>
 
 namespace Qi
 {
@@ -63,13 +64,18 @@ CacheView2* ViewComposite::addCacheViewImpl(const Layout& layout, const GuiConte
     if (!selfCacheView)
         return selfCacheView;
 
+    // sub views are appended right after self view
+    // self view pointer is not stable while array grows
+    int selfIndex = selfCacheView - cacheViews.data();
     QRect localRect = selfCacheView->rect().marginsRemoved(m_margins);
 
     for (const auto& subView: m_subViews)
     {
-        subView.view->addCacheView(*subView.layout, ctx, id, selfCacheView->rSubViews(), localRect, visibleItemRect);
+        subView.view->addCacheView(*subView.layout, ctx, id, cacheViews, localRect, visibleItemRect);
     }
 
+    selfCacheView = &cacheViews[selfIndex];
+    selfCacheView->setDescendantsCount(cacheViews.size() - selfIndex - 1);
     return selfCacheView;
 }
 
@@ -88,19 +94,44 @@ QSize ViewComposite::sizeImpl(const GuiContext& ctx, ID id, ViewSizeMode sizeMod
                  size.height() + m_margins.top() + m_margins.bottom());
 }
 
+bool ViewComposite::isSizeInvariantImpl() const
+{
+    for (const auto& subView: m_subViews)
+    {
+        if (!subView.view->isSizeInvariant())
+            return false;
+    }
+
+    return true;
+}
+
+bool ViewComposite::isLayoutInvariantImpl(const Layout& layout) const
+{
+    if (!View::isLayoutInvariantImpl(layout))
+        return false;
+
+    for (const auto& subView: m_subViews)
+    {
+        if (!subView.view->isLayoutInvariant(*subView.layout))
+            return false;
+    }
+
+    return true;
+}
+
 void ViewComposite::drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* /*showTooltip*/) const
 {
+    QVarLengthArray<const CacheView2*, 8> subCacheViews;
     for (const auto& subCacheView: cache.cacheView.subViews())
     {
         subCacheView.draw(painter, ctx, cache.id, cache.itemRect, cache.visibleRect);
+        subCacheViews.append(&subCacheView);
     }
 
     // restore draw state in reversed order
-    const auto& subCacheViews = cache.cacheView.subViews();
     for (int i = subCacheViews.size() - 1; i >= 0; --i)
     {
-        const auto& subCacheView = subCacheViews[i];
-        subCacheView.cleanupDraw(painter, ctx, cache.id, cache.itemRect, cache.visibleRect);
+        subCacheViews[i]->cleanupDraw(painter, ctx, cache.id, cache.itemRect, cache.visibleRect);
     }
 }
 /*
@@ -148,10 +179,10 @@ void ViewComposite::disconnectSubViews()
     }
 }
 
-void ViewComposite::onSubViewChanged(const View* /*view*/, ChangeReason reason)
+void ViewComposite::onSubViewChanged(const View* /*view*/, ChangeReason reason, const ChangedItems& items)
 {
     // forward signal
-    emitViewChanged(reason);
+    emitViewChanged(reason, items);
 }
 
 } // end namespace Qi
@@ -42,12 +42,14 @@ protected:
     void addViewImpl(ID id, QVector<const View*>& views) const override;
     CacheView2* addCacheViewImpl(const Layout& layout, const GuiContext& ctx, ID id, QVector<CacheView2>& cacheViews, QRect& itemRect, QRect* visibleItemRect) const override;
     QSize sizeImpl(const GuiContext& ctx, ID id, ViewSizeMode sizeMode) const override;
+    bool isSizeInvariantImpl() const override;
+    bool isLayoutInvariantImpl(const Layout& layout) const override;
     void drawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache, bool* showTooltip) const override;
     //void cleanupDrawImpl(QPainter* painter, const GuiContext& ctx, const CacheContext& cache) const override;
     bool textImpl(ID id, QString& txt) const override;
 
 private slots:
-    void onSubViewChanged(const View* view, ChangeReason reason);
+    void onSubViewChanged(const View* view, ChangeReason reason, const ChangedItems& items);
 
 private:
     void connectSubViews();
@@ -44,7 +44,7 @@ protected:
     Model* modelImpl() override { return m_model.data(); }
 
 private slots:
-    void onModelChanged(const Model*) { emitViewChanged(ChangeReasonViewContent); }
+    void onModelChanged(const Model*, const ChangedItems& items) { emitViewChanged(ChangeReasonViewContent, items); }
 
 private:
     SharedPtr<Model_t> m_model;
@@ -32,6 +32,12 @@ public:
     QVector<EnumType> uniqueValues() const { return uniqueValuesImpl(); }
     QString valueText(EnumType value) const { return valueTextImpl(value); }
     int compareValues(EnumType left, EnumType right) const
+    {
+        return Private::compareValues(valueOrder(left), valueOrder(right));
+    }
+
+    // position of the value in sorted unique values
+    int valueOrder(EnumType value) const
     {
         if (m_sortedUniqueValues.isEmpty())
         {
@@ -39,13 +45,9 @@ public:
             sortUniqueValuesImpl(m_sortedUniqueValues);
         }
 
-        auto leftIndex = std::distance(m_sortedUniqueValues.begin(), std::lower_bound(m_sortedUniqueValues.begin(),
-                                                                                      m_sortedUniqueValues.end(),
-                                                                                      left));
-        auto rightIndex = std::distance(m_sortedUniqueValues.begin(), std::lower_bound(m_sortedUniqueValues.begin(),
-                                                                                       m_sortedUniqueValues.end(),
-                                                                                       right));
-        return Private::compareValues(leftIndex, rightIndex);
+        return (int)std::distance(m_sortedUniqueValues.begin(), std::lower_bound(m_sortedUniqueValues.begin(),
+                                                                                 m_sortedUniqueValues.end(),
+                                                                                 value));
     }
 
 protected:
@@ -90,6 +92,15 @@ protected:
         return m_enumTraits->compareValues(m_enumValues->value(left), m_enumValues->value(right));
     }
 
+    UniquePtr<SortKeys> sortKeysImpl(int linesCount, const std::function<ID(int)>& lineToId) const override
+    {
+        // sort by enum value orders
+        auto keys = makeUnique<SortKeysTyped<int>>(linesCount);
+        for (int line = 0; line < linesCount; ++line)
+            keys->append(m_enumTraits->valueOrder(m_enumValues->value(lineToId(line))));
+        return std::move(keys);
+    }
+
     ValueType_t valueImpl(ID id) const override
     {
         return m_enumValues->value(id);
@@ -128,6 +139,10 @@ protected:
     {
         return m_modelEnum->compare(left, right);
     }
+    UniquePtr<SortKeys> sortKeysImpl(int linesCount, const std::function<ID(int)>& lineToId) const override
+    {
+        return m_modelEnum->sortKeys(linesCount, lineToId);
+    }
     bool isAscendingDefaultImpl(ID id) const override
     {
         return m_modelEnum->isAscendingDefault(id);
@@ -176,20 +191,8 @@ public:
     {
     }
 
-protected:
-    QSize sizeImpl(const GuiContext& ctx, ID id, ViewSizeMode sizeMode) const override
-    {
-        EnumType value = m_model->value(id);
-        auto it = m_sizes.find(value);
-        if (it != m_sizes.end())
-            return it.value();
-
-        return m_sizes[value] = ViewText::sizeImpl(ctx, id, sizeMode);
-    }
-
 private:
     SharedPtr<ModelEnum<EnumType>> m_model;
-    mutable QMap<EnumType, QSize> m_sizes;
 };
 
 } // end namespace Qi
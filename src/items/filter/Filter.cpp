@@ -33,6 +33,11 @@ ItemsFilter::~ItemsFilter()
         disconnect(m_modelToFilter.data(), &Model::modelChanged, this, &ItemsFilter::onModelToFilterChanged);
 }
 
+bool ItemsFilter::isReadThreadSafeImpl() const
+{
+    return !m_modelToFilter.isNull() && m_modelToFilter->isReadThreadSafe();
+}
+
 void ItemsFilter::onModelToFilterChanged(const Model*)
 {
     emit filterChanged(this);
@@ -35,6 +35,8 @@ public:
 
     const SharedPtr<Model>& modelToFilter() const { return m_modelToFilter; }
     bool isItemPassFilter(ID id) const { return isItemPassFilterImpl(id); }
+    // filter can be evaluated from several threads simultaneously
+    bool isReadThreadSafe() const { return isReadThreadSafeImpl(); }
 
 signals:
     void filterChanged(const ItemsFilter*);
@@ -43,6 +45,7 @@ protected:
     ItemsFilter(SharedPtr<Model> modelToFilter);
 
     virtual bool isItemPassFilterImpl(ID id) const = 0;
+    virtual bool isReadThreadSafeImpl() const;
 
 private:
     void onModelToFilterChanged(const Model*);
@@ -15,6 +15,10 @@
 */
 
 #include "FilterText.h"
+#include "utils/CallLater.h"
+#include <QStringMatcher>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
 
 namespace Qi
 {
@@ -35,8 +39,33 @@ bool ItemsFilterByText::setFilterText(const QString& filterText)
     return true;
 }
 
+bool ItemsFilterByText::isFilterTextRefinementOfImpl(const QString& /*oldFilterText*/) const
+{
+    return false;
+}
+
+void ItemsFilterByText::filterRowsPassImpl(int column, int beginRow, int endRow, QVector<bool>& pass) const
+{
+    Q_ASSERT(beginRow >= 0 && endRow <= pass.size());
+
+    for (GridID id(beginRow, column); id.row < endRow; ++id.row)
+    {
+        if (pass[id.row] && !isItemPassFilterImpl(ID(id)))
+            pass[id.row] = false;
+    }
+}
+
+// don't bother thread pool with small grids
+static const int ParallelRowsMin = 16 * 1024;
+// rows refined per event loop iteration
+static const int RefineRowsChunk = 64 * 1024;
+
 RowsFilterByText::RowsFilterByText()
-    : m_isActive(true)
+    : m_isActive(true),
+      m_isParallel(false),
+      m_isPassRowsValid(false),
+      m_refineRow(0),
+      m_refineGeneration(0)
 {
 }
 
@@ -65,6 +94,7 @@ bool RowsFilterByText::addFilterByColumn(int column, SharedPtr<ItemsFilterByText
 
     connect(filter.data(), &ItemsFilterByText::filterChanged, this, &RowsFilterByText::onFilterChanged);
     m_filterByColumn[column] = std::move(filter);
+    invalidatePassRows();
 
     return true;
 }
@@ -76,6 +106,7 @@ void RowsFilterByText::clearFilters()
         if (!filter.isNull())
             disconnect(filter.data(), &ItemsFilterByText::filterChanged, this, &RowsFilterByText::onFilterChanged);
     }
+    invalidatePassRows();
 }
 
 void RowsFilterByText::setActive(bool isActive)
@@ -84,10 +115,19 @@ void RowsFilterByText::setActive(bool isActive)
         return;
 
     m_isActive = isActive;
+    invalidatePassRows();
     emit visibilityChanged(this);
 }
 
 bool RowsFilterByText::isLineVisibleImpl(int row) const
+{
+    if (m_isPassRowsValid && row < m_passRows.size())
+        return m_passRows[row];
+
+    return isRowPassFilters(row);
+}
+
+bool RowsFilterByText::isRowPassFilters(int row) const
 {
     for (GridID id(row, 0); id.column < m_filterByColumn.size(); ++id.column)
     {
@@ -101,11 +141,189 @@ bool RowsFilterByText::isLineVisibleImpl(int row) const
     return true;
 }
 
-void RowsFilterByText::onFilterChanged(const ItemsFilter*)
+void RowsFilterByText::filterLinesVisibleImpl(int beginRow, int endRow, QVector<bool>& visible) const
+{
+    if (beginRow != 0)
+    {
+        // partial range cannot be cached
+        evaluateRowsPass(beginRow, endRow, visible);
+        return;
+    }
+
+    if (!m_isPassRowsValid || m_passRows.size() != endRow)
+    {
+        // full pass supersedes in-flight refinement
+        ++m_refineGeneration;
+        m_refineColumns.clear();
+
+        m_passRows.fill(true, endRow);
+        evaluateRowsPass(0, endRow, m_passRows);
+
+        m_passTexts.resize(m_filterByColumn.size());
+        for (int column = 0; column < m_filterByColumn.size(); ++column)
+        {
+            const auto& filter = m_filterByColumn[column];
+            m_passTexts[column] = filter.isNull() ? QString() : filter->filterText();
+        }
+
+        m_isPassRowsValid = true;
+    }
+
+    for (int row = 0; row < endRow; ++row)
+    {
+        if (!m_passRows[row])
+            visible[row] = false;
+    }
+}
+
+void RowsFilterByText::evaluateRowsPass(int beginRow, int endRow, QVector<bool>& visible) const
+{
+    if (!isParallelAllowed(endRow - beginRow))
+    {
+        filterRowsVisible(beginRow, endRow, visible);
+        return;
+    }
+
+    struct RowsChunk
+    {
+        int beginRow;
+        int endRow;
+    };
+
+    // several chunks per thread to balance uneven rows
+    int chunkSize = qMax(ParallelRowsMin / 4, (endRow - beginRow) / (QThread::idealThreadCount() * 4) + 1);
+    QVector<RowsChunk> chunks;
+    for (int row = beginRow; row < endRow; row += chunkSize)
+    {
+        RowsChunk chunk = { row, qMin(row + chunkSize, endRow) };
+        chunks.append(chunk);
+    }
+
+    // detach before workers write disjoint parts of the vector
+    visible.detach();
+
+    QtConcurrent::blockingMap(chunks, [this, &visible](const RowsChunk& chunk) {
+        filterRowsVisible(chunk.beginRow, chunk.endRow, visible);
+    });
+}
+
+void RowsFilterByText::filterRowsVisible(int beginRow, int endRow, QVector<bool>& visible) const
 {
+    // sweep rows column by column, so each column model is queried in a tight loop
+    for (int column = 0; column < m_filterByColumn.size(); ++column)
+    {
+        const auto& filter = m_filterByColumn[column];
+        if (filter.isNull())
+            continue;
+
+        filter->filterRowsPass(column, beginRow, endRow, visible);
+    }
+}
+
+bool RowsFilterByText::isParallelAllowed(int rowsCount) const
+{
+    if (!m_isParallel || rowsCount < ParallelRowsMin || QThread::idealThreadCount() < 2)
+        return false;
+
+    for (const auto& filter: m_filterByColumn)
+    {
+        if (!filter.isNull() && !filter->isReadThreadSafe())
+            return false;
+    }
+
+    return true;
+}
+
+void RowsFilterByText::onFilterChanged(const ItemsFilter* changedFilter)
+{
+    if (m_isPassRowsValid)
+    {
+        for (int column = 0; column < m_filterByColumn.size(); ++column)
+        {
+            const auto& filter = m_filterByColumn[column];
+            if (filter.data() != changedFilter)
+                continue;
+
+            // only rows passed previous text can pass the new one
+            const QString& passText = m_passTexts.value(column);
+            if (filter->filterText() != passText && filter->isFilterTextRefinementOf(passText))
+            {
+                m_passTexts.resize(m_filterByColumn.size());
+                m_passTexts[column] = filter->filterText();
+                if (!m_refineColumns.contains(column))
+                    m_refineColumns.append(column);
+
+                startRefine();
+                return;
+            }
+
+            break;
+        }
+    }
+
+    invalidatePassRows();
     emit visibilityChanged(this);
 }
 
+void RowsFilterByText::invalidatePassRows()
+{
+    // abort in-flight refinement
+    ++m_refineGeneration;
+    m_refineColumns.clear();
+
+    m_isPassRowsValid = false;
+    m_passRows.clear();
+    m_passTexts.clear();
+}
+
+void RowsFilterByText::startRefine()
+{
+    // restart from the first row, stale pass (if any) is dropped on the next chunk
+    // but all rows it has refined stay valid because new text is stricter
+    ++m_refineGeneration;
+    m_refineRow = 0;
+    refineChunk();
+}
+
+void RowsFilterByText::refineChunk()
+{
+    int beginRow = m_refineRow;
+    int endRow = qMin(beginRow + RefineRowsChunk, m_passRows.size());
+
+    QVector<bool> passRowsBefore = m_passRows.mid(beginRow, endRow - beginRow);
+    for (int column: m_refineColumns)
+    {
+        const auto& filter = m_filterByColumn[column];
+        if (!filter.isNull())
+            filter->filterRowsPass(column, beginRow, endRow, m_passRows);
+    }
+
+    QVector<int> changedRows;
+    for (int row = beginRow; row < endRow; ++row)
+    {
+        if (passRowsBefore[row - beginRow] && !m_passRows[row])
+            changedRows.append(row);
+    }
+
+    m_refineRow = endRow;
+
+    if (m_refineRow < m_passRows.size())
+    {
+        int generation = m_refineGeneration;
+        callLater(this, [this, generation]() {
+            if (generation == m_refineGeneration)
+                refineChunk();
+        });
+    }
+    else
+    {
+        m_refineColumns.clear();
+    }
+
+    if (!changedRows.isEmpty())
+        emit linesVisibilityChanged(this, changedRows);
+}
+
 SharedPtr<View> makeViewRowsFilterByText(SharedPtr<RowsFilterByText> filter)
 {
     auto modelFilterText = makeShared<ModelTextCallback>();
@@ -161,5 +379,32 @@ bool ItemsFilterTextByText::isItemPassFilterImpl(ID id) const
     return textValue.contains(filterText());
 }
 
+bool ItemsFilterTextByText::isFilterTextRefinementOfImpl(const QString& oldFilterText) const
+{
+    // items don't contain old text cannot contain new text
+    return filterText().contains(oldFilterText);
+}
+
+void ItemsFilterTextByText::filterRowsPassImpl(int column, int beginRow, int endRow, QVector<bool>& pass) const
+{
+    Q_ASSERT(beginRow >= 0 && endRow <= pass.size());
+
+    if (isFilterTextEmpty())
+        return;
+
+    // prepare search once for the whole range
+    QStringMatcher matcher(filterText());
+    const ModelText& modelText = *m_modelText;
+
+    for (GridID id(beginRow, column); id.row < endRow; ++id.row)
+    {
+        if (!pass[id.row])
+            continue;
+
+        if (matcher.indexIn(modelText.value(ID(id))) == -1)
+            pass[id.row] = false;
+    }
+}
+
 
 } // end namespace Qi
@@ -37,9 +37,19 @@ public:
 
     bool isFilterTextEmpty() const { return m_filterText.isEmpty(); }
 
+    // clears pass[row] for rows in range [beginRow, endRow) of the column which don't pass the filter
+    // rows already cleared are not evaluated
+    void filterRowsPass(int column, int beginRow, int endRow, QVector<bool>& pass) const { filterRowsPassImpl(column, beginRow, endRow, pass); }
+
+    // returns true if every item failed old filter text fails current filter text too
+    bool isFilterTextRefinementOf(const QString& oldFilterText) const { return isFilterTextRefinementOfImpl(oldFilterText); }
+
 protected:
     ItemsFilterByText(SharedPtr<Model> modelToFilter);
 
+    virtual void filterRowsPassImpl(int column, int beginRow, int endRow, QVector<bool>& pass) const;
+    virtual bool isFilterTextRefinementOfImpl(const QString& oldFilterText) const;
+
 private:
     QString m_filterText;
 };
@@ -60,14 +70,40 @@ public:
     bool isActive() const { return m_isActive; }
     void setActive(bool isActive);
 
+    // evaluate rows on thread pool if all filters are read thread safe
+    bool isParallel() const { return m_isParallel; }
+    void setParallel(bool isParallel) { m_isParallel = isParallel; }
+
 protected:
     bool isLineVisibleImpl(int row) const override;
+    void filterLinesVisibleImpl(int beginRow, int endRow, QVector<bool>& visible) const override;
 
 private:
-    void onFilterChanged(const ItemsFilter*);
+    void onFilterChanged(const ItemsFilter* changedFilter);
+    bool isRowPassFilters(int row) const;
+    void evaluateRowsPass(int beginRow, int endRow, QVector<bool>& visible) const;
+    void filterRowsVisible(int beginRow, int endRow, QVector<bool>& visible) const;
+    bool isParallelAllowed(int rowsCount) const;
+
+    void invalidatePassRows();
+    void startRefine();
+    void refineChunk();
 
     mutable QVector<SharedPtr<ItemsFilterByText>> m_filterByColumn;
     bool m_isActive;
+    bool m_isParallel;
+
+    // rows passed all filters during the last full pass
+    // refined incrementally while filter texts grow
+    mutable QVector<bool> m_passRows;
+    mutable bool m_isPassRowsValid;
+    // filter texts m_passRows were evaluated for
+    mutable QVector<QString> m_passTexts;
+
+    // in-flight refinement state
+    mutable QVector<int> m_refineColumns;
+    int m_refineRow;
+    mutable int m_refineGeneration;
 };
 
 QI_EXPORT SharedPtr<View> makeViewRowsFilterByText(SharedPtr<RowsFilterByText> filter);
@@ -82,6 +118,8 @@ public:
 
 protected:
     bool isItemPassFilterImpl(ID id) const override;
+    void filterRowsPassImpl(int column, int beginRow, int endRow, QVector<bool>& pass) const override;
+    bool isFilterTextRefinementOfImpl(const QString& oldFilterText) const override;
 
 private:
     SharedPtr<ModelText> m_modelText;
@@ -67,6 +67,12 @@ protected:
         return Private::compareValues(m_modelNumeric->value(left), m_modelNumeric->value(right));
     }
 
+    UniquePtr<SortKeys> sortKeysImpl(int linesCount, const std::function<ID(int)>& lineToId) const override
+    {
+        // sort by numeric keys
+        return m_modelNumeric->sortKeys(linesCount, lineToId);
+    }
+
     ValueType_t valueImpl(ID id) const override
     {
         return Private::numericToText<NumericType>(m_modelNumeric->value(id));
@@ -143,11 +143,48 @@ void ModelSelectionRows::selectRows(const QSet<int>& rows)
     setSelection(makeShared<RangeGridRows>(rows));
 }
 
+bool ModelSelectionRows::selectedRegionImpl(GridRegion& region) const
+{
+    GridRegion selection;
+    if (!m_selection.toRegion(selection))
+        return false;
+
+    // row is selected if selection contains its header item
+    region.clear();
+    for (const auto& band : selection.bands())
+    {
+        if (band.columns.contains(InvalidIndex))
+            region.unite(IntervalSet(band.rowBegin, band.rowEnd), IntervalSet::all());
+    }
+
+    return true;
+}
+
+bool ModelSelectionRow::selectedRegionImpl(GridRegion& region) const
+{
+    region.clear();
+    int row = activeId().row;
+    if (row != InvalidIndex)
+        region.unite(IntervalSet(row, row + 1), IntervalSet::all());
+
+    return true;
+}
+
 void ModelSelectionColumns::selectColumns(const QSet<int>& columns)
 {
     setSelection(makeShared<RangeGridColumns>(columns));
 }
 
+bool ModelSelectionColumns::selectedRegionImpl(GridRegion& region) const
+{
+    region.clear();
+    int column = activeId().column;
+    if (column != InvalidIndex)
+        region.unite(IntervalSet::all(), IntervalSet(column, column + 1));
+
+    return true;
+}
+
 ViewSelectionClient::ViewSelectionClient(const SharedPtr<ModelSelection> &model, bool useDefaultController)
     : ViewModeled<ModelSelection>(model)
 {
@@ -375,7 +412,7 @@ bool ControllerMouseSelectionClient::processContextMenu(QContextMenuEvent* /*eve
     m_model->setActiveId(id);
 
     if (!m_model->isItemSelected(id))
-        m_model->setSelection(makeRangeID(ID(id)));
+        m_model->setSelection(makeRangeGridRect(id));
 
     return false;
 }
@@ -672,7 +709,7 @@ bool ControllerKeyboardSelection::processKeyPress(QKeyEvent* event)
     {
         if (event->modifiers() & Qt::ControlModifier)
         {
-            m_model->addSelection(makeRangeID(ID(m_model->activeId())), m_model->isItemSelected(m_model->activeId()));
+            m_model->addSelection(makeRangeGridRect(m_model->activeId()), m_model->isItemSelected(m_model->activeId()));
         }
         else
         {
@@ -706,7 +743,7 @@ bool ControllerKeyboardSelection::processKeyPress(QKeyEvent* event)
         else
         {
             m_model->setActiveVisibleId(trackVisibleId);
-            m_model->setSelection(makeRangeID(ID(m_model->activeId())));
+            m_model->setSelection(makeRangeGridRect(m_model->activeId()));
         }
 
         m_widgetCore->ensureVisible(ID(trackVisibleId), m_cacheSpace, false);
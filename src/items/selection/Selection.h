@@ -43,6 +43,8 @@ public:
 
     bool isItemSelected(GridID id) const { return isItemSelectedImpl(id); }
     bool isVisibleItemSelected(GridID visibleId) const;
+    // fills region with selected items, returns false if selection is not representable as region
+    bool selectedRegion(GridRegion& region) const { return selectedRegionImpl(region); }
 
     void addSelection(SharedPtr<Range> range, bool exclude);
     void setSelection(SharedPtr<Range> range);
@@ -74,6 +76,7 @@ protected:
     bool isAscendingDefaultImpl(ID /*id*/) const override { return false; }
 
     virtual bool isItemSelectedImpl(GridID id) const { return m_selection.hasItem(ID(id)); }
+    virtual bool selectedRegionImpl(GridRegion& region) const { return m_selection.toRegion(region); }
 
     void emitChangedSignals(ChangeReason changeReason);
 
@@ -98,6 +101,7 @@ public:
 
 protected:
     bool isItemSelectedImpl(GridID id) const override { return isRowSelected(id.row); }
+    bool selectedRegionImpl(GridRegion& region) const override;
 };
 
 class QI_EXPORT ModelSelectionRow: public ModelSelection
@@ -115,6 +119,7 @@ public:
 
 protected:
     bool isItemSelectedImpl(GridID id) const override { return isRowSelected(id.row); }
+    bool selectedRegionImpl(GridRegion& region) const override;
 };
 
 class QI_EXPORT ModelSelectionColumns: public ModelSelection
@@ -132,6 +137,7 @@ public:
 
 protected:
     bool isItemSelectedImpl(GridID id) const override { return isColumnSelected(id.column); }
+    bool selectedRegionImpl(GridRegion& region) const override;
 };
 
 class QI_EXPORT ViewSelectionClient: public ViewModeled<ModelSelection>
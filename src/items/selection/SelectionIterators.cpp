@@ -15,6 +15,7 @@
 */
 
 #include "SelectionIterators.h"
+#include <algorithm>
 
 namespace Qi
 {
@@ -22,7 +23,10 @@ namespace Qi
 IdIteratorSelectedVisible::IdIteratorSelectedVisible(const ModelSelection& selection)
     : m_selection(selection),
       m_rows(nullptr),
-      m_columns(nullptr)
+      m_columns(nullptr),
+      m_hasRegion(false),
+      m_rowIndex(0),
+      m_columnIndex(0)
 {
     const auto& spaceGrid = m_selection.space();
     m_rows = spaceGrid.rows().data();
@@ -39,13 +43,23 @@ bool IdIteratorSelectedVisible::atFirstImpl()
         return false;
     }
 
+    GridRegion region;
+    m_hasRegion = m_selection.selectedRegion(region);
+    if (m_hasRegion)
+    {
+        initRegion(region);
+        m_rowIndex = 0;
+        m_columnIndex = -1;
+        return toNextInRegion();
+    }
+
     m_currentVisibleId = GridID(0, 0);
     m_currentAbsId = GridID(m_rows->toAbsolute(m_currentVisibleId.row), m_columns->toAbsolute(m_currentVisibleId.column));
 
     if (m_selection.isItemSelected(m_currentAbsId))
         return true;
 
-    return IdIteratorSelectedVisible::toNextImpl();
+    return toNextScan();
 }
 
 bool IdIteratorSelectedVisible::toNextImpl()
@@ -53,6 +67,11 @@ bool IdIteratorSelectedVisible::toNextImpl()
     if (!m_currentAbsId.isValid())
         return false;
 
+    return m_hasRegion ? toNextInRegion() : toNextScan();
+}
+
+bool IdIteratorSelectedVisible::toNextScan()
+{
     ++m_currentVisibleId.column;
 
     for (;m_currentVisibleId.row < m_rows->visibleCount(); ++m_currentVisibleId.row, m_currentVisibleId.column = 0)
@@ -69,9 +88,68 @@ bool IdIteratorSelectedVisible::toNextImpl()
     return false;
 }
 
+bool IdIteratorSelectedVisible::toNextInRegion()
+{
+    ++m_columnIndex;
+
+    for (; m_rowIndex < m_regionRows.size(); ++m_rowIndex, m_columnIndex = 0)
+    {
+        const auto& row = m_regionRows[m_rowIndex];
+        const auto& columns = m_regionColumns[row.second];
+        if (m_columnIndex < columns.size())
+        {
+            m_currentVisibleId = GridID(row.first, columns[m_columnIndex]);
+            m_currentAbsId = GridID(m_rows->toAbsolute(m_currentVisibleId.row), m_columns->toAbsolute(m_currentVisibleId.column));
+            return true;
+        }
+    }
+
+    m_currentAbsId = GridID();
+    return false;
+}
+
+void IdIteratorSelectedVisible::initRegion(const GridRegion& region)
+{
+    // region is stored by absolute lines, map it to visible order
+    // unbounded intervals (whole rows or columns) are clipped to the lines count
+    const auto& bands = region.bands();
+
+    m_regionRows.clear();
+    m_regionColumns.clear();
+    m_regionColumns.resize(bands.size());
+
+    for (int bandIndex = 0; bandIndex < bands.size(); ++bandIndex)
+    {
+        const auto& band = bands[bandIndex];
+
+        for (int row = qMax(band.rowBegin, 0), rowEnd = qMin(band.rowEnd, m_rows->count()); row < rowEnd; ++row)
+        {
+            int visibleRow = m_rows->toVisible(row);
+            if (visibleRow != InvalidIndex)
+                m_regionRows.append(qMakePair(visibleRow, bandIndex));
+        }
+
+        auto& columns = m_regionColumns[bandIndex];
+        for (const auto& interval : band.columns.intervals())
+        {
+            for (int column = qMax(interval.begin, 0), columnEnd = qMin(interval.end, m_columns->count()); column < columnEnd; ++column)
+            {
+                int visibleColumn = m_columns->toVisible(column);
+                if (visibleColumn != InvalidIndex)
+                    columns.append(visibleColumn);
+            }
+        }
+        std::sort(columns.begin(), columns.end());
+    }
+
+    std::sort(m_regionRows.begin(), m_regionRows.end());
+}
+
 IdIteratorSelectedVisibleByColumn::IdIteratorSelectedVisibleByColumn(const ModelSelection& selection, int absColumn)
     : m_selection(selection),
-      m_rows(nullptr)
+      m_rows(nullptr),
+      m_hasRegion(false),
+      m_rowIndex(0)
 {
     auto spaceGrid = &m_selection.space();
     Q_ASSERT(spaceGrid);
@@ -88,17 +166,41 @@ bool IdIteratorSelectedVisibleByColumn::atFirstImpl()
 {
     if (m_rows->isEmptyVisible() || m_currentVisibleId.column == InvalidIndex)
     {
-        m_currentAbsId = GridID();
+        m_currentAbsId.row = InvalidIndex;
         return false;
     }
 
+    GridRegion region;
+    m_hasRegion = m_selection.selectedRegion(region);
+    if (m_hasRegion)
+    {
+        // collect visible rows selected in the column
+        m_regionRows.clear();
+        for (const auto& band : region.bands())
+        {
+            if (!band.columns.contains(m_currentAbsId.column))
+                continue;
+
+            for (int row = qMax(band.rowBegin, 0), rowEnd = qMin(band.rowEnd, m_rows->count()); row < rowEnd; ++row)
+            {
+                int visibleRow = m_rows->toVisible(row);
+                if (visibleRow != InvalidIndex)
+                    m_regionRows.append(visibleRow);
+            }
+        }
+        std::sort(m_regionRows.begin(), m_regionRows.end());
+
+        m_rowIndex = -1;
+        return toNextInRegion();
+    }
+
     m_currentVisibleId.row = 0;
     m_currentAbsId.row = m_rows->toAbsolute(m_currentVisibleId.row);
 
     if (m_selection.isItemSelected(m_currentAbsId))
         return true;
 
-    return IdIteratorSelectedVisibleByColumn::toNextImpl();
+    return toNextScan();
 }
 
 bool IdIteratorSelectedVisibleByColumn::toNextImpl()
@@ -106,6 +208,11 @@ bool IdIteratorSelectedVisibleByColumn::toNextImpl()
     if (!m_currentAbsId.isValid())
         return false;
 
+    return m_hasRegion ? toNextInRegion() : toNextScan();
+}
+
+bool IdIteratorSelectedVisibleByColumn::toNextScan()
+{
     ++m_currentVisibleId.row;
 
     for (;m_currentVisibleId.row < m_rows->visibleCount(); ++m_currentVisibleId.row)
@@ -115,7 +222,22 @@ bool IdIteratorSelectedVisibleByColumn::toNextImpl()
             return true;
     }
 
-    m_currentAbsId = GridID();
+    m_currentAbsId.row = InvalidIndex;
+    return false;
+}
+
+bool IdIteratorSelectedVisibleByColumn::toNextInRegion()
+{
+    ++m_rowIndex;
+
+    if (m_rowIndex < m_regionRows.size())
+    {
+        m_currentVisibleId.row = m_regionRows[m_rowIndex];
+        m_currentAbsId.row = m_rows->toAbsolute(m_currentVisibleId.row);
+        return true;
+    }
+
+    m_currentAbsId.row = InvalidIndex;
     return false;
 }
 
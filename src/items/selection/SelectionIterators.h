@@ -25,7 +25,10 @@ namespace Qi
 
 class Lines;
 
-class QI_EXPORT IdIteratorSelectedVisible: public IdIterator
+// iterates selected visible items in visible order
+// if selection is described by region it enumerates region cells only,
+// otherwise it checks every visible item
+class QI_EXPORT IdIteratorSelectedVisible: public IdIteratorGrid
 {
 public:
     explicit IdIteratorSelectedVisible(const ModelSelection& selection);
@@ -33,19 +36,31 @@ public:
     GridID visibleId() const { return m_currentVisibleId; }
 
 protected:
-    ID idImpl() const override { return ID(m_currentAbsId); }
+    GridID gridIdImpl() const override { return m_currentAbsId; }
     bool atFirstImpl() override;
     bool toNextImpl() override;
 
 private:
+    bool toNextScan();
+    bool toNextInRegion();
+    void initRegion(const GridRegion& region);
+
     const ModelSelection& m_selection;
     const Lines* m_rows;
     const Lines* m_columns;
     GridID m_currentVisibleId;
     GridID m_currentAbsId;
+
+    bool m_hasRegion;
+    // visible rows of the region sorted, paired with band index
+    QVector<QPair<int, int>> m_regionRows;
+    // sorted visible columns of each band
+    QVector<QVector<int>> m_regionColumns;
+    int m_rowIndex;
+    int m_columnIndex;
 };
 
-class QI_EXPORT IdIteratorSelectedVisibleByColumn: public IdIterator
+class QI_EXPORT IdIteratorSelectedVisibleByColumn: public IdIteratorGrid
 {
 public:
     explicit IdIteratorSelectedVisibleByColumn(const ModelSelection& selection, int absColumn = 0);
@@ -53,17 +68,32 @@ public:
     GridID visibleId() const { return m_currentVisibleId; }
 
 protected:
-    ID idImpl() const override { return ID(m_currentAbsId); }
+    GridID gridIdImpl() const override { return m_currentAbsId; }
     bool atFirstImpl() override;
     bool toNextImpl() override;
 
 private:
+    bool toNextScan();
+    bool toNextInRegion();
+
     const ModelSelection& m_selection;
     const Lines* m_rows;
     GridID m_currentVisibleId;
     GridID m_currentAbsId;
+
+    bool m_hasRegion;
+    // sorted visible rows selected in the column
+    QVector<int> m_regionRows;
+    int m_rowIndex;
 };
 
+// sets value to all selected visible items of the model
+template <typename Model, typename Value>
+bool setValueSelected(Model& model, const ModelSelection& selection, const Value& value)
+{
+    IdIteratorSelectedVisible it(selection);
+    return model.setValueMultiple(it, value);
+}
 
 } // end namespace Qi
 
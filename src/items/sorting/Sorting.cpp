@@ -16,6 +16,7 @@
 
 #include "Sorting.h"
 #include "space/grid/SpaceGrid.h"
+#include <QMouseEvent>
 
 namespace Qi
 {
@@ -23,13 +24,16 @@ namespace Qi
 ModelGridSortingBase::ModelGridSortingBase(SharedPtr<SpaceGrid> grid)
     : m_grid(std::move(grid)),
       m_ascending(false),
-      m_sortingExpired(false)
+      m_sortingExpired(false),
+      m_isParallel(false),
+      m_isLiveSorting(false)
 {
 }
 
 void ModelGridSortingBase::clearActiveSortingId()
 {
     m_activeSortingId = GridID();
+    m_nextSortingKeys.clear();
     emit modelChanged(this);
 }
 
@@ -40,11 +44,64 @@ void ModelGridSortingBase::setSorting(GridID id, bool ascending)
 
     m_activeSortingId = id;
     m_ascending = ascending;
+    m_nextSortingKeys.clear();
     m_sortingExpired = true;
 }
 
+QVector<ModelGridSortingBase::SortingKey> ModelGridSortingBase::sortingKeys() const
+{
+    QVector<SortingKey> keys;
+    if (!m_activeSortingId.isValid())
+        return keys;
+
+    SortingKey activeKey = { m_activeSortingId, m_ascending };
+    keys.append(activeKey);
+    keys += m_nextSortingKeys;
+    return keys;
+}
+
+void ModelGridSortingBase::setSortingKeys(const QVector<SortingKey>& keys)
+{
+    if (keys.isEmpty() || !keys.first().id.isValid())
+        return;
+
+    setSorting(keys.first().id, keys.first().ascending);
+    m_nextSortingKeys = keys.mid(1);
+}
+
+int ModelGridSortingBase::sortingPriority(GridID id) const
+{
+    if (m_sortingExpired || !m_activeSortingId.isValid())
+        return 0;
+
+    if (m_activeSortingId == id)
+        return 1;
+
+    for (int i = 0; i < m_nextSortingKeys.size(); ++i)
+    {
+        if (m_nextSortingKeys[i].id == id)
+            return i + 2;
+    }
+
+    return 0;
+}
+
+bool ModelGridSortingBase::isAscending(GridID id) const
+{
+    for (const auto& key : m_nextSortingKeys)
+    {
+        if (key.id == id)
+            return key.ascending;
+    }
+
+    return m_ascending;
+}
+
 bool ModelGridSortingBase::sort()
 {
+    if (!m_nextSortingKeys.isEmpty())
+        return sortByKeys();
+
     return sortByItem(m_activeSortingId, m_ascending);
 }
 
@@ -67,11 +124,12 @@ bool ModelGridSortingBase::defaultSortByItem(GridID id)
 
     m_activeSortingId = id;
     m_ascending = model->isAscendingDefault(ID(id));
+    m_nextSortingKeys.clear();
     m_sortingExpired = false;
 
     emit willSortItems(this);
 
-    m_grid->sortColumnByModel(id.column, *model, m_ascending, true);
+    m_grid->sortColumnByModel(id.column, *model, m_ascending, true, m_isParallel);
 
     emit didSortItems(this);
     emit modelChanged(this);
@@ -90,11 +148,74 @@ bool ModelGridSortingBase::sortByItem(GridID id, bool ascending)
 
     m_activeSortingId = id;
     m_ascending = ascending;
+    m_nextSortingKeys.clear();
     m_sortingExpired = false;
 
     emit willSortItems(this);
 
-    m_grid->sortColumnByModel(id.column, *model, m_ascending, true);
+    m_grid->sortColumnByModel(id.column, *model, m_ascending, true, m_isParallel);
+
+    emit didSortItems(this);
+    emit modelChanged(this);
+
+    return true;
+}
+
+bool ModelGridSortingBase::addSortByItem(GridID id)
+{
+    if (!m_activeSortingId.isValid())
+        return defaultSortByItem(id);
+
+    auto model = sortingModel(id);
+    if (!model)
+        return false;
+
+    if (m_activeSortingId == id)
+    {
+        m_ascending = !m_ascending;
+        return sortByKeys();
+    }
+
+    for (auto& key : m_nextSortingKeys)
+    {
+        if (key.id == id)
+        {
+            key.ascending = !key.ascending;
+            return sortByKeys();
+        }
+    }
+
+    SortingKey key = { id, model->isAscendingDefault(ID(id)) };
+    m_nextSortingKeys.append(key);
+    return sortByKeys();
+}
+
+bool ModelGridSortingBase::sortByKeys()
+{
+    auto keys = sortingKeys();
+
+    // hold models while sorting
+    QVector<SharedPtr<ModelComparable>> models;
+    QVector<SortingColumn> columns;
+    for (const auto& key : keys)
+    {
+        auto model = sortingModel(key.id);
+        if (!model)
+            continue;
+
+        SortingColumn column = { key.id.column, model.data(), key.ascending };
+        columns.append(column);
+        models.append(std::move(model));
+    }
+
+    if (columns.isEmpty())
+        return false;
+
+    m_sortingExpired = false;
+
+    emit willSortItems(this);
+
+    m_grid->sortColumnsByModels(columns, true, m_isParallel);
 
     emit didSortItems(this);
     emit modelChanged(this);
@@ -112,16 +233,82 @@ void ModelGridSortingBase::disconnectModel(const Model* model)
     disconnect(model, &Model::modelChanged, this, &ModelGridSortingBase::onSortingModelChanged);
 }
 
-void ModelGridSortingBase::onSortingModelChanged(const Model* model)
+void ModelGridSortingBase::onSortingModelChanged(const Model* model, const ChangedItems& items)
 {
-    if (!m_activeSortingId.isValid())
+    if (m_sortingExpired || !isSortingModel(model))
         return;
 
-    if (sortingModel(m_activeSortingId).data() == model)
+    // move changed rows only if they are listed
+    if (m_isLiveSorting && items.range.isNull() && !items.ids.isEmpty())
     {
-        // mark sorting as expired
-        m_sortingExpired = true;
+        if (resortChangedRows(model, items.ids))
+            return;
     }
+
+    // mark sorting as expired
+    m_sortingExpired = true;
+}
+
+bool ModelGridSortingBase::resortChangedRows(const Model* model, const QVector<ID>& items)
+{
+    QVector<SharedPtr<ModelComparable>> models;
+    QVector<SortingColumn> columns;
+    for (const auto& key : sortingKeys())
+    {
+        auto keyModel = sortingModel(key.id);
+        if (!keyModel)
+            continue;
+
+        SortingColumn column = { key.id.column, keyModel.data(), key.ascending };
+        columns.append(column);
+        models.append(std::move(keyModel));
+    }
+
+    // only rows changed in sorted columns should be moved
+    QVector<int> rows;
+    for (const auto& item : items)
+    {
+        GridID id = item.as<GridID>();
+        if (id.row < 0 || id.row >= m_grid->rowsCount())
+            continue;
+
+        for (const auto& column : columns)
+        {
+            if (column.column == id.column && column.model == model)
+            {
+                rows.append(id.row);
+                break;
+            }
+        }
+    }
+
+    if (columns.isEmpty())
+        return false;
+
+    if (rows.isEmpty())
+        return true;
+
+    emit willSortItems(this);
+
+    m_grid->resortRowsByModels(rows, columns);
+
+    emit didSortItems(this);
+
+    return true;
+}
+
+bool ModelGridSortingBase::isSortingModel(const Model* model) const
+{
+    if (!m_activeSortingId.isValid())
+        return false;
+
+    for (const auto& key : sortingKeys())
+    {
+        if (sortingModel(key.id).data() == model)
+            return true;
+    }
+
+    return false;
 }
 
 ModelGridSorting::ModelGridSorting(SharedPtr<SpaceGrid> grid)
@@ -291,13 +478,24 @@ void ViewGridSorting::drawImpl(QPainter* painter, const GuiContext& ctx, const C
     rect.adjust(4, 4, -4, -4);
     painter->drawRoundedRect(rect, 20.f, 20.f, Qt::RelativeSize);
 
-    if (theModel()->activeSortingId() == cache.id.as<GridID>())
+    GridID id = cache.id.as<GridID>();
+    int priority = theModel()->sortingPriority(id);
+    if (priority > 0)
     {
         QStyleOptionHeader option;
         ctx.initStyleOption(option);
-        option.sortIndicator = theModel()->isAscending() ? QStyleOptionHeader::SortUp : QStyleOptionHeader::SortDown;
+        option.sortIndicator = theModel()->isAscending(id) ? QStyleOptionHeader::SortUp : QStyleOptionHeader::SortDown;
         option.rect = rect;
 
+        // show priority number if sorted by several columns
+        if (theModel()->sortingKeys().size() > 1)
+        {
+            QRect numberRect = rect;
+            numberRect.setLeft(rect.center().x() + 1);
+            option.rect.setRight(rect.center().x());
+            painter->drawText(numberRect, Qt::AlignCenter, QString::number(priority));
+        }
+
         ctx.style()->drawPrimitive(QStyle::PE_IndicatorHeaderArrow, &option, painter, ctx.widget);
     }
 
@@ -306,26 +504,40 @@ void ViewGridSorting::drawImpl(QPainter* painter, const GuiContext& ctx, const C
 
 bool ViewGridSorting::tooltipTextImpl(ID id, QString& txt) const
 {
-    if (theModel()->activeSortingId() == id.as<GridID>())
+    int priority = theModel()->sortingPriority(id.as<GridID>());
+    if (priority > 0)
     {
-        txt = theModel()->isAscending() ? "Ascending" : "Descending";
+        txt = theModel()->isAscending(id.as<GridID>()) ? "Ascending" : "Descending";
+        if (theModel()->sortingKeys().size() > 1)
+            txt += QString(" (%1)").arg(priority);
     }
     else
     {
-        txt = "Click to sort";
+        txt = "Click to sort, Ctrl+Click to add sorting";
     }
 
     return true;
 }
 
 ControllerMouseGridSorting::ControllerMouseGridSorting(SharedPtr<ModelGridSortingBase> model)
-    : m_model(std::move(model))
+    : m_model(std::move(model)),
+      m_addSorting(false)
+{
+}
+
+bool ControllerMouseGridSorting::processLButtonDown(QMouseEvent* event)
 {
+    // Ctrl key adds column to compound sorting
+    m_addSorting = (event->modifiers() & Qt::ControlModifier);
+    return ControllerMouseCaptured::processLButtonDown(event);
 }
 
 void ControllerMouseGridSorting::applyImpl()
 {
-    m_model->sortByItem(activationState().id.as<GridID>());
+    if (m_addSorting)
+        m_model->addSortByItem(activationState().id.as<GridID>());
+    else
+        m_model->sortByItem(activationState().id.as<GridID>());
 }
 
 } // end namespace Qi
@@ -36,6 +36,12 @@ class QI_EXPORT ModelGridSortingBase: public Model
     Q_DISABLE_COPY(ModelGridSortingBase)
 
 public:
+    struct SortingKey
+    {
+        GridID id;
+        bool ascending;
+    };
+
     ModelGridSortingBase(SharedPtr<SpaceGrid> grid);
 
     SharedPtr<ModelComparable> sortingModel(GridID id) const { return sortingModelImpl(id); }
@@ -45,10 +51,27 @@ public:
     bool isAscending() const { return m_ascending; }
     void setSorting(GridID id, bool ascending);
 
+    // compound sorting, first key is the active sorting id
+    QVector<SortingKey> sortingKeys() const;
+    void setSortingKeys(const QVector<SortingKey>& keys);
+    // returns 1 for the active sorting id, 2 for the next key and so on, 0 if id is not sorted
+    int sortingPriority(GridID id) const;
+    bool isAscending(GridID id) const;
+
+    // sort lines using several threads
+    bool isParallel() const { return m_isParallel; }
+    void setParallel(bool isParallel) { m_isParallel = isParallel; }
+
+    // keep rows sorted when sorting models report changed items
+    bool isLiveSorting() const { return m_isLiveSorting; }
+    void setLiveSorting(bool isLiveSorting) { m_isLiveSorting = isLiveSorting; }
+
     bool sort();
     bool sortByItem(GridID id);
     bool defaultSortByItem(GridID id);
     bool sortByItem(GridID id, bool ascending);
+    // adds id as the next sorting key or toggles its direction
+    bool addSortByItem(GridID id);
 
 signals:
     void willSortItems(const ModelGridSortingBase*);
@@ -61,12 +84,19 @@ protected:
     void disconnectModel(const Model* model);
 
 private:
-    void onSortingModelChanged(const Model* model);
+    void onSortingModelChanged(const Model* model, const ChangedItems& items);
+    bool resortChangedRows(const Model* model, const QVector<ID>& items);
+    bool isSortingModel(const Model* model) const;
+    bool sortByKeys();
 
     SharedPtr<SpaceGrid> m_grid;
     bool m_ascending;
     GridID m_activeSortingId;
+    // keys following the active sorting id
+    QVector<SortingKey> m_nextSortingKeys;
     bool m_sortingExpired;
+    bool m_isParallel;
+    bool m_isLiveSorting;
 };
 
 class QI_EXPORT ModelGridSorting: public ModelGridSortingBase
@@ -179,11 +209,14 @@ class QI_EXPORT ControllerMouseGridSorting: public ControllerMouseCaptured
 public:
     ControllerMouseGridSorting(SharedPtr<ModelGridSortingBase> model);
 
+    bool processLButtonDown(QMouseEvent* event) override;
+
 protected:
     void applyImpl() override;
 
 private:
     SharedPtr<ModelGridSortingBase> m_model;
+    bool m_addSorting;
 };
 
 } // end namespace Qi
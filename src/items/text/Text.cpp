@@ -15,8 +15,11 @@
 */
 
 #include "Text.h"
+#include "TextMetrics.h"
 #include <QStyleOptionViewItem>
+#include <QStyle>
 #include <QLineEdit>
+#include <QtMath>
 
 namespace Qi
 {
@@ -25,7 +28,8 @@ ViewText::ViewText(const SharedPtr<ModelText> &model, ViewDefaultController crea
     : ViewModeled<ModelText>(model),
       m_alignment(alignment),
       m_textElideMode(textElideMode),
-      m_margins(2, 0, 2, 0)
+      m_margins(2, 0, 2, 0),
+      m_isStaticTextEnabled(false)
 {
     if (createDefaultController)
     {
@@ -60,6 +64,15 @@ void ViewText::setMargins(const QMargins& margins)
     emitViewChanged(ChangeReasonViewSize);
 }
 
+void ViewText::setStaticTextEnabled(bool enabled)
+{
+    if (m_isStaticTextEnabled == enabled)
+        return;
+
+    m_isStaticTextEnabled = enabled;
+    emitViewChanged(ChangeReasonViewContent);
+}
+
 QSize ViewText::sizeImpl(const GuiContext& ctx, ID id, ViewSizeMode sizeMode) const
 {
     return sizeText(theModel()->value(id), ctx, id, sizeMode);
@@ -88,9 +101,11 @@ QSize ViewText::sizeText(const QString& text, const GuiContext& ctx, ID /*id*/,
 
     return ctx.widget->style()->sizeFromContents(QStyle::CT_ItemViewItem, &option, QSize(0, 0), ctx.widget) + QSize(5, 5);
     */
-    QFontMetrics fontMetrics = ctx.widget->fontMetrics();
-    return QSize(fontMetrics.width(text) + m_margins.left() + m_margins.right(),
-                 fontMetrics.height() + m_margins.top() + m_margins.bottom());
+    const QFont& font = ctx.widget->font();
+    int textWidth = cachedTextWidth(font, ctx.widget, text);
+    int textHeight = cachedTextHeight(font, ctx.widget);
+    return QSize(textWidth + m_margins.left() + m_margins.right(),
+                 textHeight + m_margins.top() + m_margins.bottom());
 }
 
 void ViewText::drawText(const QString& text, QPainter* painter, const GuiContext& /*ctx*/, const CacheContext& cache, bool* showTooltip) const
@@ -110,10 +125,12 @@ void ViewText::drawText(const QString& text, QPainter* painter, const GuiContext
 
     QRect rect = cache.cacheView.rect().marginsRemoved(m_margins);
     QString textToDraw = text;
+    const QFont& font = painter->font();
+    const QPaintDevice* device = painter->device();
     Qt::TextElideMode elideMode = textElideMode(cache.id);
     if (elideMode != Qt::ElideNone)
     {
-        QString elidedText = painter->fontMetrics().elidedText(textToDraw, elideMode, rect.width());
+        QString elidedText = cachedElidedText(font, device, textToDraw, elideMode, rect.width());
         if (showTooltip)
             *showTooltip = (elidedText != textToDraw);
 
@@ -122,10 +139,25 @@ void ViewText::drawText(const QString& text, QPainter* painter, const GuiContext
     else
     {
         if (showTooltip)
-            *showTooltip = (painter->fontMetrics().width(text) > rect.width());
+            *showTooltip = (cachedTextWidth(font, device, text) > rect.width());
+    }
+
+    Qt::Alignment textAlignment = alignment(cache.id);
+
+    if (m_isStaticTextEnabled && !(textAlignment & ~(Qt::AlignHorizontal_Mask | Qt::AlignVertical_Mask)) && !textToDraw.contains(QLatin1Char('\n')))
+    {
+        QStaticText staticText = cachedStaticText(font, device, textToDraw);
+        QSize textSize(qCeil(staticText.size().width()), qCeil(staticText.size().height()));
+        // drawText clips text by rect, static text is drawn only if it fits
+        if (textSize.width() <= rect.width() && textSize.height() <= rect.height())
+        {
+            QRect textRect = QStyle::alignedRect(painter->layoutDirection(), textAlignment, textSize, rect);
+            painter->drawStaticText(textRect.topLeft(), staticText);
+            return;
+        }
     }
 
-    painter->drawText(rect, alignment(cache.id), textToDraw);
+    painter->drawText(rect, textAlignment, textToDraw);
 }
 
 
@@ -48,6 +48,11 @@ public:
     const QMargins& margins() const { return m_margins; }
     void setMargins(const QMargins& margins);
 
+    // draws single line texts with prepared QStaticText
+    // suitable for frequently repainted items with repetitive texts
+    bool isStaticTextEnabled() const { return m_isStaticTextEnabled; }
+    void setStaticTextEnabled(bool enabled);
+
 protected:
     virtual Qt::Alignment alignmentImpl(ID /*id*/) const { return m_alignment; }
     virtual Qt::TextElideMode textElideModeImpl(ID /*id*/) const { return m_textElideMode; }
@@ -63,6 +68,7 @@ private:
     Qt::Alignment m_alignment;
     Qt::TextElideMode m_textElideMode;
     QMargins m_margins;
+    bool m_isStaticTextEnabled;
 };
 
 class QI_EXPORT ViewTextOrHint: public ViewText
@@ -0,0 +1,158 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#include "TextMetrics.h"
+#include <QFontMetrics>
+#include <QPaintDevice>
+#include <QCache>
+
+namespace Qi
+{
+
+// maximum number of cached widths and elided texts
+static const int maxCachedTexts = 20000;
+
+struct TextKey
+{
+    QFont font;
+    int dpiX;
+    int dpiY;
+    QString text;
+    Qt::TextElideMode mode;
+    int width;
+
+    TextKey(const QFont& font, const QPaintDevice* device, const QString& text, Qt::TextElideMode mode = Qt::ElideNone, int width = 0)
+        : font(font),
+          dpiX(device ? device->logicalDpiX() : 0),
+          dpiY(device ? device->logicalDpiY() : 0),
+          text(text), mode(mode), width(width)
+    {}
+
+    bool operator==(const TextKey& other) const
+    {
+        return dpiX == other.dpiX && dpiY == other.dpiY && width == other.width && mode == other.mode &&
+                text == other.text && font == other.font;
+    }
+};
+
+static uint qHash(const TextKey& key, uint seed = 0)
+{
+    return qHash(key.text, qHash(key.font, seed)) ^ uint(key.dpiX) ^ (uint(key.dpiY) << 16) ^ (uint(key.width) << 8) ^ uint(key.mode);
+}
+
+static QFontMetrics fontMetrics(const QFont& font, const QPaintDevice* device)
+{
+    // QFontMetrics doesn't modify the device
+    return device ? QFontMetrics(font, const_cast<QPaintDevice*>(device)) : QFontMetrics(font);
+}
+
+static QCache<TextKey, int>& textWidths()
+{
+    static QCache<TextKey, int> cache(maxCachedTexts);
+    return cache;
+}
+
+static QCache<TextKey, int>& textHeights()
+{
+    // one entry per font and device dpi
+    static QCache<TextKey, int> cache(maxCachedTexts);
+    return cache;
+}
+
+static QCache<TextKey, QString>& elidedTexts()
+{
+    static QCache<TextKey, QString> cache(maxCachedTexts);
+    return cache;
+}
+
+static QCache<TextKey, QStaticText>& staticTexts()
+{
+    static QCache<TextKey, QStaticText> cache(maxCachedTexts);
+    return cache;
+}
+
+int cachedTextWidth(const QFont& font, const QPaintDevice* device, const QString& text)
+{
+    if (text.isEmpty())
+        return 0;
+
+    TextKey key(font, device, text);
+    auto& cache = textWidths();
+    if (const int* width = cache.object(key))
+        return *width;
+
+    int width = fontMetrics(font, device).width(text);
+    cache.insert(key, new int(width));
+    return width;
+}
+
+int cachedTextHeight(const QFont& font, const QPaintDevice* device)
+{
+    TextKey key(font, device, QString());
+    auto& cache = textHeights();
+    if (const int* height = cache.object(key))
+        return *height;
+
+    int height = fontMetrics(font, device).height();
+    cache.insert(key, new int(height));
+    return height;
+}
+
+QString cachedElidedText(const QFont& font, const QPaintDevice* device, const QString& text, Qt::TextElideMode mode, int width)
+{
+    if (mode == Qt::ElideNone || text.isEmpty())
+        return text;
+
+    // text fits without eliding
+    if (cachedTextWidth(font, device, text) <= width)
+        return text;
+
+    TextKey key(font, device, text, mode, width);
+    auto& cache = elidedTexts();
+    if (const QString* elidedText = cache.object(key))
+        return *elidedText;
+
+    QString elidedText = fontMetrics(font, device).elidedText(text, mode, width);
+    cache.insert(key, new QString(elidedText));
+    return elidedText;
+}
+
+QStaticText cachedStaticText(const QFont& font, const QPaintDevice* device, const QString& text)
+{
+    TextKey key(font, device, text);
+    auto& cache = staticTexts();
+    if (const QStaticText* staticText = cache.object(key))
+        return *staticText;
+
+    QStaticText* staticText = new QStaticText(text);
+    staticText->setTextFormat(Qt::PlainText);
+    staticText->setPerformanceHint(QStaticText::AggressiveCaching);
+    // lay out text with the font resolved for the device
+    staticText->prepare(QTransform(), device ? QFont(font, const_cast<QPaintDevice*>(device)) : font);
+    cache.insert(key, staticText);
+    return *staticText;
+}
+
+void clearTextMetricsCache()
+{
+    textWidths().clear();
+    textHeights().clear();
+    elidedTexts().clear();
+    staticTexts().clear();
+}
+
+} // end namespace Qi
@@ -0,0 +1,45 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+
+#ifndef QI_TEXT_METRICS_H
+#define QI_TEXT_METRICS_H
+
+#include "QiAPI.h"
+#include <QFont>
+#include <QString>
+#include <QStaticText>
+
+class QPaintDevice;
+
+namespace Qi
+{
+
+// text measurements shared by all text views
+// text is measured against the paint device (widget, printer, etc.)
+// results are cached per font and device dpi, cache size is bounded
+QI_EXPORT int cachedTextWidth(const QFont& font, const QPaintDevice* device, const QString& text);
+QI_EXPORT int cachedTextHeight(const QFont& font, const QPaintDevice* device);
+QI_EXPORT QString cachedElidedText(const QFont& font, const QPaintDevice* device, const QString& text, Qt::TextElideMode mode, int width);
+// single line plain text prepared for the font on the paint device
+QI_EXPORT QStaticText cachedStaticText(const QFont& font, const QPaintDevice* device, const QString& text);
+
+// should be called if fonts were changed without QFont change (new application fonts)
+QI_EXPORT void clearTextMetricsCache();
+
+} // end namespace Qi
+
+#endif // QI_TEXT_METRICS_H
@@ -18,8 +18,10 @@
 #include "widgets/GridWidget.h"
 #include "widgets/ListWidget.h"
 #include "cache/CacheItemFactory.h"
+#include "space/grid/CacheSpaceGrid.h"
 #include "utils/CallLater.h"
 #include <QEvent>
+#include <QElapsedTimer>
 
 namespace Qi
 {
@@ -60,6 +62,125 @@ int calculateGridColumnFitWidth(const GridWidget& gridWidget, int columnsId, int
     return fitWidth;
 }
 
+ColumnFitWidthSampler::ColumnFitWidthSampler(int visibleColumn, const GuiContext& ctx)
+    : m_visibleColumn(visibleColumn),
+      m_ctx(ctx)
+{
+}
+
+void ColumnFitWidthSampler::addGrid(const SharedPtr<SpaceGrid>& grid, const SharedPtr<CacheSpaceGrid>& cacheGrid)
+{
+    Q_ASSERT(grid);
+
+    GridInfo info;
+    info.grid = grid;
+    info.factory = grid->createCacheItemFactory();
+    info.visibleRowStart = InvalidIndex;
+    info.visibleRowEnd = InvalidIndex;
+
+    if (cacheGrid)
+    {
+        GridID idStart, idEnd;
+        cacheGrid->visibleItemsRange(idStart, idEnd);
+        info.visibleRowStart = idStart.row;
+        info.visibleRowEnd = idEnd.row;
+    }
+
+    m_grids.append(info);
+}
+
+int ColumnFitWidthSampler::estimate(int samplesCount)
+{
+    Q_ASSERT(samplesCount > 0);
+
+    m_fitWidth = 0;
+    m_isExact = false;
+    m_refineGrid = 0;
+    m_refineRow = 0;
+
+    int totalRowsCount = rowsCount();
+    if (totalRowsCount <= samplesCount)
+    {
+        // small column, measure it completely
+        for (const auto& info : m_grids)
+        {
+            for (int row = 0; row < info.grid->rowsVisibleCount(); ++row)
+                measure(info, row);
+        }
+
+        m_isExact = true;
+        m_refineGrid = m_grids.size();
+        return m_fitWidth;
+    }
+
+    for (const auto& info : m_grids)
+    {
+        int gridRowsCount = info.grid->rowsVisibleCount();
+        if (gridRowsCount == 0)
+            continue;
+
+        // currently visible rows
+        if (info.visibleRowStart >= 0)
+        {
+            for (int row = info.visibleRowStart; row <= qMin(info.visibleRowEnd, gridRowsCount - 1); ++row)
+                measure(info, row);
+        }
+
+        // one sample from the middle of each stratum
+        int gridSamplesCount = qMax(1, int(qint64(samplesCount) * gridRowsCount / totalRowsCount));
+        for (int sample = 0; sample < gridSamplesCount; ++sample)
+            measure(info, int((qint64(sample) * 2 + 1) * gridRowsCount / (2 * gridSamplesCount)));
+    }
+
+    return m_fitWidth;
+}
+
+bool ColumnFitWidthSampler::refine(int timeLimit)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    while (m_refineGrid < m_grids.size())
+    {
+        const auto& info = m_grids[m_refineGrid];
+
+        int gridRowsCount = info.grid->rowsVisibleCount();
+        while (m_refineRow < gridRowsCount)
+        {
+            measure(info, m_refineRow++);
+
+            // check timer once per 16 rows
+            if (((m_refineRow & 15) == 0) && (timer.elapsed() >= timeLimit))
+                return false;
+        }
+
+        ++m_refineGrid;
+        m_refineRow = 0;
+    }
+
+    m_isExact = true;
+    return true;
+}
+
+int ColumnFitWidthSampler::rowsCount() const
+{
+    int count = 0;
+    for (const auto& info : m_grids)
+        count += info.grid->rowsVisibleCount();
+    return count;
+}
+
+void ColumnFitWidthSampler::measure(const GridInfo& info, int row)
+{
+    // column may be hidden during refinement
+    if (m_visibleColumn >= info.grid->columnsVisibleCount())
+        return;
+
+    CacheItem cacheItem(info.factory->create(ID(GridID(row, m_visibleColumn))));
+    cacheItem.validateCacheView(m_ctx);
+    m_fitWidth = qMax(m_fitWidth, cacheItem.calculateItemSize(m_ctx, ViewSizeModeExact).width());
+}
+
 namespace Impl
 {
 
@@ -87,6 +208,10 @@ GridColumnsResizer::GridColumnsResizer(GridWidget* gridWidget)
         connect(m_gridWidget->columns(id).data(), &Lines::linesChanged, this, &GridColumnsResizer::onColumnsChanged);
         initColumns(id, m_gridWidget->columns(id)->count());
     }
+
+    for (int row = 0; row < 3; ++row)
+        for (int column = 0; column < 3; ++column)
+            connect(m_gridWidget->subGrid(GridID(row, column)).data(), &Space::spaceChanged, this, &GridColumnsResizer::onSpaceChanged);
 }
 
 GridColumnsResizer::~GridColumnsResizer()
@@ -100,6 +225,10 @@ GridColumnsResizer::~GridColumnsResizer()
             disconnect(m_gridWidget->rows(id).data(), &Lines::linesChanged, this, &GridColumnsResizer::onRowsChanged);
             disconnect(m_gridWidget->columns(id).data(), &Lines::linesChanged, this, &GridColumnsResizer::onColumnsChanged);
         }
+
+        for (int row = 0; row < 3; ++row)
+            for (int column = 0; column < 3; ++column)
+                disconnect(m_gridWidget->subGrid(GridID(row, column)).data(), &Space::spaceChanged, this, &GridColumnsResizer::onSpaceChanged);
     }
 }
 
@@ -191,6 +320,8 @@ void GridColumnsResizer::invalidateFitCache()
             }
         }
 
+    m_fitSamplers.clear();
+
     if (isResizingRequired)
         doResizeLater();
 }
@@ -215,6 +346,10 @@ void GridColumnsResizer::onRowsChanged(const Lines* /*lines*/, ChangeReason reas
 
 void GridColumnsResizer::onColumnsChanged(const Lines* lines, ChangeReason reason)
 {
+    // samplers measure columns by visible index
+    if ((reason & (ChangeReasonLinesVisibility | ChangeReasonLinesOrder)) && !m_fitSamplers.empty())
+        invalidateFitCache();
+
     if (reason & ChangeReasonLinesCount)
     {
         for (int id = 0; id < 3; ++id)
@@ -228,12 +363,22 @@ void GridColumnsResizer::onColumnsChanged(const Lines* lines, ChangeReason reaso
     }
 }
 
+void GridColumnsResizer::onSpaceChanged(const Space* /*space*/, ChangeReason reason)
+{
+    // samplers hold item factories built for previous schemas
+    if ((reason & ChangeReasonSpaceItemsStructure) && !m_fitSamplers.empty())
+        invalidateFitCache();
+}
+
 void GridColumnsResizer::initColumns(int columnsId, int count)
 {
     auto& columns = m_columns[columnsId];
     if (columns.size() == count)
         return;
 
+    m_fitSamplers.erase(m_fitSamplers.lower_bound(std::make_pair(columnsId, 0)),
+                        m_fitSamplers.lower_bound(std::make_pair(columnsId + 1, 0)));
+
     if (count == 0)
     {
         columns.clear();
@@ -318,7 +463,7 @@ int GridColumnsResizer::doResizeColumns(int columnsId, int remainsWidth)
             auto& info = columnsInfo[column];
             if (info.mode == ColumnResizeModeFit)
             {
-                columns.setLineSize(column, columnFitWidth(columnsId, columns.toVisible(column), info));
+                columns.setLineSize(column, columnFitWidth(columnsId, column, columns.toVisible(column), info));
                 widthProcessed += columns.lineSize(column);
             }
         }
@@ -379,16 +524,78 @@ int GridColumnsResizer::doResizeColumns(int columnsId, int remainsWidth)
     return remainsWidth;
 }
 
-int GridColumnsResizer::columnFitWidth(int columnsId, int visibleColumn, Impl::ColumnResizeModeInfo& info)
+int GridColumnsResizer::columnFitWidth(int columnsId, int column, int visibleColumn, Impl::ColumnResizeModeInfo& info)
 {
     Q_ASSERT(info.mode == ColumnResizeModeFit);
 
     if (info.param.fitSizeCache == FitSizeCacheInvalid)
-        info.param.fitSizeCache = calculateGridColumnFitWidth(*m_gridWidget, columnsId, visibleColumn);
+    {
+        auto sampler = makeUnique<ColumnFitWidthSampler>(visibleColumn, m_gridWidget->guiContext());
+        for (int row = 0; row < 3; ++row)
+        {
+            GridID subGridId(row, columnsId);
+            sampler->addGrid(m_gridWidget->subGrid(subGridId), m_gridWidget->cacheSubGrid(subGridId));
+        }
+
+        // use estimation now and refine it later
+        info.param.fitSizeCache = sampler->estimate();
+        if (sampler->isExact())
+        {
+            m_fitSamplers.erase(std::make_pair(columnsId, column));
+        }
+        else
+        {
+            m_fitSamplers[std::make_pair(columnsId, column)] = std::move(sampler);
+            refineFitWidthsLater();
+        }
+    }
 
     return info.param.fitSizeCache;
 }
 
+void GridColumnsResizer::refineFitWidthsLater()
+{
+    if (m_isRefineScheduled)
+        return;
+
+    m_isRefineScheduled = true;
+    callLater(this, [this]() { refineFitWidths(); });
+}
+
+void GridColumnsResizer::refineFitWidths()
+{
+    m_isRefineScheduled = false;
+
+    if (m_gridWidget.isNull() || m_fitSamplers.empty())
+        return;
+
+    // refine one column per slice
+    auto it = m_fitSamplers.begin();
+    if (it->second->refine())
+    {
+        int columnsId = it->first.first;
+        int column = it->first.second;
+        int fitWidth = it->second->fitWidth();
+        m_fitSamplers.erase(it);
+
+        auto& columnsInfo = m_columns[columnsId];
+        if (column < columnsInfo.size())
+        {
+            auto& info = columnsInfo[column];
+            if (info.mode == ColumnResizeModeFit &&
+                info.param.fitSizeCache != FitSizeCacheInvalid &&
+                info.param.fitSizeCache != fitWidth)
+            {
+                info.param.fitSizeCache = fitWidth;
+                doResizeLater();
+            }
+        }
+    }
+
+    if (!m_fitSamplers.empty())
+        refineFitWidthsLater();
+}
+
 
 ListColumnsResizer::ListColumnsResizer(ListWidget* listWidget)
     : m_listWidget(listWidget)
@@ -398,6 +605,7 @@ ListColumnsResizer::ListColumnsResizer(ListWidget* listWidget)
 
     connect(m_listWidget->rows().data(), &Lines::linesChanged, this, &ListColumnsResizer::onRowsChanged);
     connect(m_listWidget->columns().data(), &Lines::linesChanged, this, &ListColumnsResizer::onColumnsChanged);
+    connect(m_listWidget->grid().data(), &Space::spaceChanged, this, &ListColumnsResizer::onSpaceChanged);
     initColumns(m_listWidget->columns()->count());
 }
 
@@ -409,6 +617,7 @@ ListColumnsResizer::~ListColumnsResizer()
 
         disconnect(m_listWidget->rows().data(), &Lines::linesChanged, this, &ListColumnsResizer::onRowsChanged);
         disconnect(m_listWidget->columns().data(), &Lines::linesChanged, this, &ListColumnsResizer::onColumnsChanged);
+        disconnect(m_listWidget->grid().data(), &Space::spaceChanged, this, &ListColumnsResizer::onSpaceChanged);
     }
 }
 
@@ -495,6 +704,8 @@ void ListColumnsResizer::invalidateFitCache()
         }
     }
 
+    m_fitSamplers.clear();
+
     if (isResizingRequired)
         doResizeLater();
 }
@@ -520,18 +731,31 @@ void ListColumnsResizer::onRowsChanged(const Lines* /*lines*/, ChangeReason reas
 
 void ListColumnsResizer::onColumnsChanged(const Lines* /*lines*/, ChangeReason reason)
 {
+    // samplers measure columns by visible index
+    if ((reason & (ChangeReasonLinesVisibility | ChangeReasonLinesOrder)) && !m_fitSamplers.empty())
+        invalidateFitCache();
+
     if (reason & ChangeReasonLinesCount)
     {
         initColumns(m_listWidget->columns()->count());
     }
 }
 
+void ListColumnsResizer::onSpaceChanged(const Space* /*space*/, ChangeReason reason)
+{
+    // samplers hold item factories built for previous schemas
+    if ((reason & ChangeReasonSpaceItemsStructure) && !m_fitSamplers.empty())
+        invalidateFitCache();
+}
+
 void ListColumnsResizer::initColumns(int count)
 {
     auto& columns = m_columns;
     if (columns.size() == count)
         return;
 
+    m_fitSamplers.clear();
+
     if (count == 0)
     {
         columns.clear();
@@ -609,7 +833,7 @@ int ListColumnsResizer::doResizeColumns(int remainsWidth)
             auto& info = columnsInfo[column];
             if (info.mode == ColumnResizeModeFit)
             {
-                columns.setLineSize(column, columnFitWidth(columns.toVisible(column), info));
+                columns.setLineSize(column, columnFitWidth(column, columns.toVisible(column), info));
                 widthProcessed += columns.lineSize(column);
             }
         }
@@ -668,16 +892,72 @@ int ListColumnsResizer::doResizeColumns(int remainsWidth)
     return remainsWidth;
 }
 
-int ListColumnsResizer::columnFitWidth(int visibleColumn, Impl::ColumnResizeModeInfo& info)
+int ListColumnsResizer::columnFitWidth(int column, int visibleColumn, Impl::ColumnResizeModeInfo& info)
 {
     Q_ASSERT(info.mode == ColumnResizeModeFit);
 
     if (info.param.fitSizeCache == FitSizeCacheInvalid)
-        info.param.fitSizeCache = calculateColumnFitWidth(*m_listWidget->grid(), visibleColumn, m_listWidget->guiContext());
+    {
+        auto sampler = makeUnique<ColumnFitWidthSampler>(visibleColumn, m_listWidget->guiContext());
+        sampler->addGrid(m_listWidget->grid(), m_listWidget->cacheGrid());
+
+        // use estimation now and refine it later
+        info.param.fitSizeCache = sampler->estimate();
+        if (sampler->isExact())
+        {
+            m_fitSamplers.erase(column);
+        }
+        else
+        {
+            m_fitSamplers[column] = std::move(sampler);
+            refineFitWidthsLater();
+        }
+    }
 
     return info.param.fitSizeCache;
 }
 
+void ListColumnsResizer::refineFitWidthsLater()
+{
+    if (m_isRefineScheduled)
+        return;
+
+    m_isRefineScheduled = true;
+    callLater(this, [this]() { refineFitWidths(); });
+}
+
+void ListColumnsResizer::refineFitWidths()
+{
+    m_isRefineScheduled = false;
+
+    if (m_listWidget.isNull() || m_fitSamplers.empty())
+        return;
+
+    // refine one column per slice
+    auto it = m_fitSamplers.begin();
+    if (it->second->refine())
+    {
+        int column = it->first;
+        int fitWidth = it->second->fitWidth();
+        m_fitSamplers.erase(it);
+
+        if (column < m_columns.size())
+        {
+            auto& info = m_columns[column];
+            if (info.mode == ColumnResizeModeFit &&
+                info.param.fitSizeCache != FitSizeCacheInvalid &&
+                info.param.fitSizeCache != fitWidth)
+            {
+                info.param.fitSizeCache = fitWidth;
+                doResizeLater();
+            }
+        }
+    }
+
+    if (!m_fitSamplers.empty())
+        refineFitWidthsLater();
+}
+
 ControllerMouseColumnsAutoFit::ControllerMouseColumnsAutoFit(GridWidget* gridWidget, int columnsID, ControllerMousePriority priority)
     : ControllerMouse(priority),
       m_gridWidget(gridWidget),
@@ -686,9 +966,45 @@ ControllerMouseColumnsAutoFit::ControllerMouseColumnsAutoFit(GridWidget* gridWid
 
 bool ControllerMouseColumnsAutoFit::processLButtonDblClick(QMouseEvent* /*event*/)
 {
-    int fitWidth = calculateGridColumnFitWidth(*m_gridWidget, m_columnsID, column(activationState().visibleId()));
+    resetFitSampler();
+
+    m_fitSampler = makeUnique<ColumnFitWidthSampler>(column(activationState().visibleId()), m_gridWidget->guiContext());
+    for (int row = 0; row < 3; ++row)
+    {
+        GridID subGridId(row, m_columnsID);
+        m_fitSampler->addGrid(m_gridWidget->subGrid(subGridId), m_gridWidget->cacheSubGrid(subGridId));
+    }
+    m_fitColumn = column(activationState().id);
+
+    int fitWidth = m_fitSampler->estimate();
     if (fitWidth > 0)
-        m_gridWidget->columns(m_columnsID)->setLineSize(column(activationState().id), fitWidth);
+        m_gridWidget->columns(m_columnsID)->setLineSize(m_fitColumn, fitWidth);
+
+    if (m_fitSampler->isExact())
+    {
+        m_fitSampler.reset();
+        return true;
+    }
+
+    // sampled rows or column may become stale before refinement is finished
+    auto onLinesChanged = [this](const Lines* /*lines*/, ChangeReason reason) {
+        if (reason & (ChangeReasonLinesCount | ChangeReasonLinesVisibility | ChangeReasonLinesOrder))
+            resetFitSampler();
+    };
+    auto onSpaceChanged = [this](const Space* /*space*/, ChangeReason reason) {
+        if (reason & (ChangeReasonSpaceItemsStructure | ChangeReasonSpaceItemsContent))
+            resetFitSampler();
+    };
+
+    m_fitConnections.append(connect(m_gridWidget->columns(m_columnsID).data(), &Lines::linesChanged, this, onLinesChanged));
+    for (int row = 0; row < 3; ++row)
+    {
+        m_fitConnections.append(connect(m_gridWidget->rows(row).data(), &Lines::linesChanged, this, onLinesChanged));
+        m_fitConnections.append(connect(m_gridWidget->subGrid(GridID(row, m_columnsID)).data(), &Space::spaceChanged, this, onSpaceChanged));
+    }
+
+    refineFitWidthLater();
+
     return true;
 }
 
@@ -704,5 +1020,43 @@ void ControllerMouseColumnsAutoFit::deactivateImpl()
     ControllerMouse::deactivateImpl();
 }
 
-} // end namespace Qi
+void ControllerMouseColumnsAutoFit::refineFitWidthLater()
+{
+    if (m_isRefineScheduled)
+        return;
+
+    m_isRefineScheduled = true;
+    callLater(this, [this]() { refineFitWidth(); });
+}
+
+void ControllerMouseColumnsAutoFit::refineFitWidth()
+{
+    m_isRefineScheduled = false;
 
+    if (!m_fitSampler)
+        return;
+
+    if (!m_fitSampler->refine())
+    {
+        refineFitWidthLater();
+        return;
+    }
+
+    int fitWidth = m_fitSampler->fitWidth();
+    resetFitSampler();
+
+    auto& columns = *m_gridWidget->columns(m_columnsID);
+    if (fitWidth > 0 && m_fitColumn < columns.count())
+        columns.setLineSize(m_fitColumn, fitWidth);
+}
+
+void ControllerMouseColumnsAutoFit::resetFitSampler()
+{
+    for (const auto& connection : m_fitConnections)
+        disconnect(connection);
+    m_fitConnections.clear();
+
+    m_fitSampler.reset();
+}
+
+} // end namespace Qi
@@ -19,6 +19,7 @@
 
 #include "space/grid/SpaceGrid.h"
 #include "core/ControllerMouse.h"
+#include <map>
 
 namespace Qi
 {
@@ -26,10 +27,59 @@ namespace Qi
 class GridWidget;
 class ListWidget;
 class GuiContext;
+class CacheSpaceGrid;
+class CacheItemFactory;
 
 QI_EXPORT int calculateColumnFitWidth(const SpaceGrid& grid, int visibleColumn, const GuiContext& ctx);
 QI_EXPORT int calculateGridColumnFitWidth(const GridWidget& gridWidget, int columnsId, int visibleColumn);
 
+// calculates column fit width progressively
+// estimate() measures currently visible rows and evenly spread sample rows,
+// refine() measures all rows in time limited slices until the true maximum is found
+class QI_EXPORT ColumnFitWidthSampler
+{
+    Q_DISABLE_COPY(ColumnFitWidthSampler)
+
+public:
+    ColumnFitWidthSampler(int visibleColumn, const GuiContext& ctx);
+
+    // cacheGrid is used to find currently visible rows
+    void addGrid(const SharedPtr<SpaceGrid>& grid, const SharedPtr<CacheSpaceGrid>& cacheGrid = SharedPtr<CacheSpaceGrid>());
+
+    int fitWidth() const { return m_fitWidth; }
+    bool isExact() const { return m_isExact; }
+
+    // measures all rows if there are no more than samplesCount rows
+    // otherwise measures visible rows and samplesCount sample rows
+    int estimate(int samplesCount = 1000);
+    // measures next rows during timeLimit milliseconds
+    // returns true when all rows are measured
+    bool refine(int timeLimit = 10);
+
+private:
+    struct GridInfo
+    {
+        SharedPtr<SpaceGrid> grid;
+        SharedPtr<CacheItemFactory> factory;
+        int visibleRowStart;
+        int visibleRowEnd;
+    };
+
+    int rowsCount() const;
+    void measure(const GridInfo& info, int row);
+
+    int m_visibleColumn;
+    const GuiContext& m_ctx;
+    QVector<GridInfo> m_grids;
+
+    int m_fitWidth = 0;
+    bool m_isExact = false;
+
+    // next row to measure in refine
+    int m_refineGrid = 0;
+    int m_refineRow = 0;
+};
+
 enum ColumnResizeMode
 {
     ColumnResizeModeNone = 0x000,
@@ -86,12 +136,18 @@ public:
 private:
     void onRowsChanged(const Lines* lines, ChangeReason reason);
     void onColumnsChanged(const Lines* lines, ChangeReason reason);
+    void onSpaceChanged(const Space* space, ChangeReason reason);
     void initColumns(int columnsId, int count);
     int doResizeColumns(int columnsId, int remainsWidth);
-    int columnFitWidth(int columnsId, int visibleColumn, Impl::ColumnResizeModeInfo& info);
+    int columnFitWidth(int columnsId, int column, int visibleColumn, Impl::ColumnResizeModeInfo& info);
+    void refineFitWidthsLater();
+    void refineFitWidths();
 
     QPointer<GridWidget> m_gridWidget;
     QVector<Impl::ColumnResizeModeInfo> m_columns[3];
+    // samplers of fit columns with estimated widths, key is (columnsId, column)
+    std::map<std::pair<int, int>, UniquePtr<ColumnFitWidthSampler>> m_fitSamplers;
+    bool m_isRefineScheduled = false;
 
     static const GridID clientID;
 };
@@ -123,12 +179,18 @@ public:
 private:
     void onRowsChanged(const Lines* lines, ChangeReason reason);
     void onColumnsChanged(const Lines* lines, ChangeReason reason);
+    void onSpaceChanged(const Space* space, ChangeReason reason);
     void initColumns(int count);
     int doResizeColumns(int remainsWidth);
-    int columnFitWidth(int visibleColumn, Impl::ColumnResizeModeInfo& info);
+    int columnFitWidth(int column, int visibleColumn, Impl::ColumnResizeModeInfo& info);
+    void refineFitWidthsLater();
+    void refineFitWidths();
 
     QPointer<ListWidget> m_listWidget;
     QVector<Impl::ColumnResizeModeInfo> m_columns;
+    // samplers of fit columns with estimated widths
+    std::map<int, UniquePtr<ColumnFitWidthSampler>> m_fitSamplers;
+    bool m_isRefineScheduled = false;
 };
 
 class QI_EXPORT ControllerMouseColumnsAutoFit: public ControllerMouse
@@ -144,8 +206,18 @@ public:
     void deactivateImpl() override;
 
 private:
+    void refineFitWidthLater();
+    void refineFitWidth();
+    void resetFitSampler();
+
     GridWidget* m_gridWidget;
     int m_columnsID;
+    // sampler of the last auto fitted column
+    UniquePtr<ColumnFitWidthSampler> m_fitSampler;
+    int m_fitColumn = InvalidIndex;
+    bool m_isRefineScheduled = false;
+    // sampler is dropped on grid changes
+    QVector<QMetaObject::Connection> m_fitConnections;
 };
 
 } // end namespace Qi
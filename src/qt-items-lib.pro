@@ -1,6 +1,6 @@
 include(../common.pri)
 
-QT += core gui widgets
+QT += core gui widgets concurrent
 
 TARGET = qt-items
 TEMPLATE = lib
@@ -34,6 +34,7 @@ SOURCES += QiAPI.cpp \
     space/grid/Lines.cpp \
     space/grid/SpaceGrid.cpp \
     space/grid/RangeGrid.cpp \
+    space/grid/GridRegion.cpp \
     space/grid/CacheSpaceGrid.cpp \
     space/item/SpaceItem.cpp \
     space/item/CacheSpaceItem.cpp \
@@ -43,10 +44,13 @@ SOURCES += QiAPI.cpp \
     cache/CacheView.cpp \
     cache/CacheControllerMouse.cpp \
     cache/CacheItemFactory.cpp \
+    cache/CacheItemPixmaps.cpp \
+    cache/CacheItemLayouts.cpp \
     items/cache/ViewCacheSpace.cpp \
     items/checkbox/Check.cpp \
     items/radiobutton/Radio.cpp \
     items/text/Text.cpp \
+    items/text/TextMetrics.cpp \
     items/selection/Selection.cpp \
     items/misc/ControllerMousePushableCallback.cpp \
     items/button/Button.cpp \
@@ -78,7 +82,10 @@ SOURCES += QiAPI.cpp \
     misc/CacheSpaceAnimation.cpp \
     utils/PainterState.cpp \
     utils/InplaceEditing.cpp \
-    utils/CallLater.cpp
+    utils/CallLater.cpp \
+    utils/FenwickTree.cpp \
+    utils/IntervalSet.cpp \
+    utils/ParallelSort.cpp
 
 HEADERS +=  QiAPI.h \
     core/ID.h \
@@ -91,6 +98,8 @@ HEADERS +=  QiAPI.h \
     core/ItemsIterator.h \
     core/ControllerKeyboard.h \
     cache/CacheItemFactory.h \
+    cache/CacheItemPixmaps.h \
+    cache/CacheItemLayouts.h \
     core/ext/LayoutsAux.h \
     core/ext/Ranges.h \
     core/ext/Views.h \
@@ -114,6 +123,7 @@ HEADERS +=  QiAPI.h \
     space/grid/CacheSpaceGrid.h \
     space/grid/GridID.h \
     space/grid/RangeGrid.h \
+    space/grid/GridRegion.h \
     space/item/SpaceItem.h \
     space/item/CacheSpaceItem.h \
     space/scene/CacheSpaceScene.h \
@@ -124,6 +134,7 @@ HEADERS +=  QiAPI.h \
     items/checkbox/Check.h \
     items/radiobutton/Radio.h \
     items/text/Text.h \
+    items/text/TextMetrics.h \
     items/selection/Selection.h \
     items/cache/ViewCacheSpace.h \
     items/misc/ControllerMousePushableCallback.h \
@@ -155,8 +166,11 @@ HEADERS +=  QiAPI.h \
     misc/GridColumnsResizer.h \
     misc/CacheSpaceAnimation.h \
     utils/CallLater.h \
+    utils/FenwickTree.h \
+    utils/IntervalSet.h \
     utils/MemFunction.h \
     utils/PainterState.h \
+    utils/ParallelSort.h \
     utils/InplaceEditing.h \
     utils/auto_value.h
 
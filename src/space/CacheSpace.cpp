@@ -18,6 +18,8 @@
 #include "core/ControllerMouse.h"
 #include "cache/CacheItem.h"
 #include "cache/CacheItemFactory.h"
+#include "cache/CacheItemPixmaps.h"
+#include "cache/CacheItemLayouts.h"
 #include "misc/CacheSpaceAnimation.h"
 #include "utils/auto_value.h"
 
@@ -31,7 +33,8 @@ CacheSpace::CacheSpace(SharedPtr<Space> space)
       m_scrollDelta(0, 0),
       m_sizeDelta(0, 0),
       m_itemsCacheInvalid(true),
-      m_cacheIsInUse(false)
+      m_cacheIsInUse(false),
+      m_layouts(makeUnique<CacheItemLayouts>())
 {
     connect(m_space.data(), &Space::spaceChanged, this, &CacheSpace::onSpaceChanged);
 
@@ -44,7 +47,7 @@ CacheSpace::~CacheSpace()
     disconnect(m_space.data(), &Space::spaceChanged, this, &CacheSpace::onSpaceChanged);
 }
 
-void CacheSpace::onSpaceChanged(const Space* space, ChangeReason reason)
+void CacheSpace::onSpaceChanged(const Space* space, ChangeReason reason, const ChangedItems& items)
 {
     Q_UNUSED(space);
     Q_ASSERT(space == m_space.data());
@@ -59,10 +62,50 @@ void CacheSpace::onSpaceChanged(const Space* space, ChangeReason reason)
     {
         // update items factory
         updateCacheItemsFactory();
+        m_layouts->clear();
+        if (m_pixmaps)
+            m_pixmaps->invalidate();
         emit cacheChanged(this, reason|ChangeReasonCacheItems);
     }
     else if (reason & ChangeReasonSpaceItemsContent)
     {
+        // views sizes may be changed
+        if (items.isAll())
+            m_layouts->clear();
+
+        if (m_pixmaps)
+        {
+            // changed items may be out of the window now
+            if (items.isAll())
+                m_pixmaps->invalidate();
+            else
+                m_pixmaps->invalidate(items);
+        }
+
+        if (!items.isAll() && !m_itemsCacheInvalid)
+        {
+            // collect window areas of changed items
+            // too fragmented region is slower than whole window repaint
+            const int maxDirtyItems = 64;
+            int dirtyItems = 0;
+            QRegion dirtyRegion;
+            forEachChangedCacheItem(items, [&dirtyItems, &dirtyRegion, this](const SharedPtr<CacheItem>& cacheItem)->bool {
+                dirtyRegion += cacheItem->rect & m_window;
+                return ++dirtyItems <= maxDirtyItems;
+            });
+
+            // changed items are out of the window
+            if (dirtyRegion.isEmpty())
+                return;
+
+            // repaint changed items only
+            if (dirtyItems <= maxDirtyItems)
+            {
+                emit cacheChanged(this, reason|ChangeReasonCacheContent, dirtyRegion);
+                return;
+            }
+        }
+
         // forward event
         emit cacheChanged(this, reason|ChangeReasonCacheContent);
     }
@@ -129,11 +172,22 @@ void CacheSpace::clearItemsCache() const
 {
     Q_ASSERT(!m_cacheIsInUse);
     clearItemsCacheImpl();
+
+    // ids may refer to other items now
+    if (m_pixmaps)
+        m_pixmaps->invalidate();
 }
 
 SharedPtr<CacheItem> CacheSpace::createCacheItem(ID visibleId) const
 {
-    return makeShared<CacheItem>(m_cacheItemsFactory->create(visibleId));
+    auto cacheItem = makeShared<CacheItem>(m_cacheItemsFactory->create(visibleId));
+    cacheItem->setLayouts(m_layouts.get());
+    return cacheItem;
+}
+
+void CacheSpace::resetCacheItem(CacheItem& cacheItem, ID visibleId) const
+{
+    cacheItem.reset(m_cacheItemsFactory->create(visibleId));
 }
 
 void CacheSpace::validateItemsCache() const
@@ -162,6 +216,26 @@ bool CacheSpace::forEachCacheItem(const std::function<bool(const SharedPtr<Cache
     return forEachCacheItemImpl(visitor);
 }
 
+bool CacheSpace::forEachChangedCacheItem(const ChangedItems& items, const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const
+{
+    Q_ASSERT(visitor);
+
+    if (items.isAll())
+        return forEachCacheItem(visitor);
+
+    return forEachChangedCacheItemImpl(items, visitor);
+}
+
+bool CacheSpace::forEachChangedCacheItemImpl(const ChangedItems& items, const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const
+{
+    // cache items store absolute ids
+    return forEachCacheItem([&items, &visitor](const SharedPtr<CacheItem>& cacheItem)->bool {
+        if (!items.hasItem(cacheItem->id))
+            return true;
+        return visitor(cacheItem);
+    });
+}
+
 bool CacheSpace::forEachCacheView(const std::function<bool(const CacheSpace::IterateInfo&)>& visitor) const
 {
     Q_ASSERT(visitor);
@@ -218,16 +292,43 @@ void CacheSpace::drawRaw(QPainter* painter, const GuiContext& ctx) const
     auto_value<bool> inUse(m_cacheIsInUse, true);
 
     painter->save();
-    painter->setClipRect(m_window);
 
-    forEachCacheItem([painter, &ctx, this](const SharedPtr<CacheItem>& cacheItem)->bool {
-                         cacheItem->draw(painter, ctx, &m_window);
+    // skip items out of the painter clip
+    QRegion drawRegion(m_window);
+    if (painter->hasClipping())
+        drawRegion &= painter->clipRegion();
+
+    painter->setClipRect(m_window, Qt::IntersectClip);
+
+    forEachCacheItem([painter, &ctx, &drawRegion, this](const SharedPtr<CacheItem>& cacheItem)->bool {
+                         if (!drawRegion.intersects(cacheItem->rect))
+                             return true;
+
+                         if (!m_pixmaps || !m_pixmaps->draw(*cacheItem, painter, ctx, &m_window))
+                             cacheItem->draw(painter, ctx, &m_window);
                          return true;
                      });
 
     painter->restore();
 }
 
+qint64 CacheSpace::pixmapsBudget() const
+{
+    return m_pixmaps ? m_pixmaps->byteBudget() : 0;
+}
+
+void CacheSpace::setPixmapsBudget(qint64 byteBudget)
+{
+    Q_ASSERT(byteBudget >= 0);
+
+    if (byteBudget <= 0)
+        m_pixmaps.reset();
+    else if (m_pixmaps)
+        m_pixmaps->setByteBudget(byteBudget);
+    else
+        m_pixmaps = makeUnique<CacheItemPixmaps>(byteBudget);
+}
+
 CacheSpaceAnimationAbstract* CacheSpace::animation() const
 {
     return m_animation.data();
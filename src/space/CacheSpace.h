@@ -18,6 +18,7 @@
 #define QI_CACHE_SPACE_H
 
 #include "Space.h"
+#include <QRegion>
 
 namespace Qi
 {
@@ -25,6 +26,8 @@ namespace Qi
 class ControllerContext;
 class CacheItem;
 class CacheItemFactory;
+class CacheItemPixmaps;
+class CacheItemLayouts;
 class CacheSpaceAnimationAbstract;
 
 class QI_EXPORT CacheSpace: public QObject
@@ -65,6 +68,11 @@ public:
     void draw(QPainter* painter, const GuiContext& ctx) const;
     void drawRaw(QPainter* painter, const GuiContext& ctx) const;
 
+    // rendered items are cached within the byte budget, zero budget disables caching
+    // items drawing nested caches are not tracked, so enable it on leaf caches only
+    qint64 pixmapsBudget() const;
+    void setPixmapsBudget(qint64 byteBudget);
+
     CacheSpaceAnimationAbstract* animation() const;
     void setAnimation(CacheSpaceAnimationAbstract* animation);
 
@@ -82,12 +90,15 @@ public:
     };
 
     bool forEachCacheItem(const std::function<bool(const SharedPtr<CacheItem> &)> &visitor) const;
+    // visits cache items of changed items only
+    bool forEachChangedCacheItem(const ChangedItems& items, const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const;
     bool forEachCacheView(const std::function<bool(const IterateInfo&)>& visitor) const;
     //bool forEachCacheView(const std::function<bool(const makeShared<CacheItem>&, CacheView2*)>& visitor);
 
 
 signals:
-    void cacheChanged(const CacheSpace* cache, ChangeReason reason);
+    // dirtyRegion is a part of the window to repaint, empty region means whole window
+    void cacheChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion = QRegion());
 
 protected:
     explicit CacheSpace(SharedPtr<Space> space);
@@ -95,10 +106,12 @@ protected:
     void validateItemsCache() const;
     void clearItemsCache() const;
     SharedPtr<CacheItem> createCacheItem(ID visibleId) const;
+    void resetCacheItem(CacheItem& cacheItem, ID visibleId) const;
 
     virtual void clearItemsCacheImpl() const = 0;
     virtual void validateItemsCacheImpl() const = 0;
     virtual bool forEachCacheItemImpl(const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const = 0;
+    virtual bool forEachChangedCacheItemImpl(const ChangedItems& items, const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const;
     virtual const CacheItem* cacheItemImpl(ID visibleId) const = 0;
     virtual const CacheItem* cacheItemByPositionImpl(QPoint point) const = 0;
 
@@ -124,10 +137,15 @@ protected:
 
     QPointer<CacheSpaceAnimationAbstract> m_animation;
 
+    // rendered items cache
+    UniquePtr<CacheItemPixmaps> m_pixmaps;
+    // layouts shared by cache items
+    UniquePtr<CacheItemLayouts> m_layouts;
+
 private:
     void invalidateItemsCache(ChangeReason reason);
 
-    void onSpaceChanged(const Space* space, ChangeReason reason);
+    void onSpaceChanged(const Space* space, ChangeReason reason, const ChangedItems& items);
     void updateCacheItemsFactory();
 };
 
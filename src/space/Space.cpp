@@ -139,12 +139,12 @@ void Space::onLayoutChanged(const Layout* /*layout*/, ChangeReason reason)
     emit spaceChanged(this, reason | ChangeReasonSpaceItemsStructure);
 }
 
-void Space::onViewChanged(const View* /*view*/, ChangeReason reason)
+void Space::onViewChanged(const View* /*view*/, ChangeReason reason, const ChangedItems& items)
 {
     if (reason & ChangeReasonViewSize)
         emit spaceChanged(this, reason | ChangeReasonSpaceItemsStructure);
     else
-        emit spaceChanged(this, reason | ChangeReasonSpaceItemsContent);
+        emit spaceChanged(this, reason | ChangeReasonSpaceItemsContent, items);
 }
 
 } // end namespace Qi
@@ -53,12 +53,13 @@ public:
     const QVector<ItemSchema>& schemasOrdered() const;
 
 signals:
-    void spaceChanged(const Space* space, ChangeReason reason);
+    // items describe changed items if they are known
+    void spaceChanged(const Space* space, ChangeReason reason, const ChangedItems& items = ChangedItems());
 
 private slots:
     void onRangeChanged(const Range* range, ChangeReason reason);
     void onLayoutChanged(const Layout* layout, ChangeReason reason);
-    void onViewChanged(const View* view, ChangeReason reason);
+    void onViewChanged(const View* view, ChangeReason reason, const ChangedItems& items);
 
 private:
     void connectSchema(const ItemSchema& schema);
@@ -21,6 +21,12 @@
 namespace Qi
 {
 
+static int ringIndex(int index, int size)
+{
+    index %= size;
+    return (index < 0) ? index + size : index;
+}
+
 CacheSpaceGrid::CacheSpaceGrid(SharedPtr<SpaceGrid> grid)
     : CacheSpace(grid),
       m_grid(grid)
@@ -83,7 +89,10 @@ void CacheSpaceGrid::clearItemsCacheImpl() const
     Q_ASSERT(!m_cacheIsInUse);
 
     m_idStart = m_idEnd = GridID();
+    m_ringOrigin = GridID(0, 0);
     m_items.clear();
+    m_newItems.clear();
+    m_itemsPool.clear();
     m_scrollDelta = QPoint(0, 0);
     m_sizeDelta = QSize(0, 0);
 }
@@ -131,10 +140,57 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
         return;
     }
 
-    // init new items with empty caches
     int newIdRows = newIdEnd.row - newIdStart.row + 1;
     int newIdColumns = newIdEnd.column - newIdStart.column + 1;
-    QVector<SharedPtr<CacheItem>> newItems(newIdRows * newIdColumns, nullptr);
+
+    if (!m_items.isEmpty() &&
+        (m_idEnd.row - m_idStart.row + 1) == newIdRows &&
+        (m_idEnd.column - m_idStart.column + 1) == newIdColumns)
+    {
+        // window size in items is the same
+        // rotate ring origin so items in both windows keep their slots
+        m_ringOrigin.row = ringIndex(m_ringOrigin.row + newIdStart.row - m_idStart.row, newIdRows);
+        m_ringOrigin.column = ringIndex(m_ringOrigin.column + newIdStart.column - m_idStart.column, newIdColumns);
+
+        GridID oldIdStart = m_idStart;
+        GridID oldIdEnd = m_idEnd;
+        m_idStart = newIdStart;
+        m_idEnd = newIdEnd;
+
+        // slots of items left the window are taken by entered items
+        QPoint origin = originPos();
+        for (GridID idVisible = m_idStart; idVisible.row <= m_idEnd.row; ++idVisible.row)
+        {
+            bool isRowRetained = idVisible.row >= oldIdStart.row && idVisible.row <= oldIdEnd.row;
+            for (idVisible.column = m_idStart.column; idVisible.column <= m_idEnd.column; ++idVisible.column)
+            {
+                auto& cacheItem = m_items[itemIndex(idVisible)];
+                if (isRowRetained && idVisible.column >= oldIdStart.column && idVisible.column <= oldIdEnd.column)
+                {
+                    cacheItem->correctRectangles(m_scrollDelta);
+                }
+                else
+                {
+                    resetCacheItem(*cacheItem, ID(idVisible));
+                    // correct rectangle
+                    cacheItem->rect.translate(origin);
+                }
+            }
+        }
+
+        // clear offset
+        m_scrollDelta = QPoint(0, 0);
+        m_sizeDelta = QSize(0, 0);
+        // mark items as valid
+        m_itemsCacheInvalid = false;
+        return;
+    }
+
+    // init new items with empty caches
+    // resize() keeps capacity of the reused array
+    auto& newItems = m_newItems;
+    newItems.resize(0);
+    newItems.resize(newIdRows * newIdColumns);
 
     if (!m_items.isEmpty())
     {
@@ -143,17 +199,22 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
         GridID intersectionEnd(qMin(m_idEnd.row, newIdEnd.row), qMin(m_idEnd.column, newIdEnd.column));
 
         // copy intersected cache items
-        int oldIdColumns = m_idEnd.column - m_idStart.column + 1;
         for (GridID id = intersectionStart; id.column <= intersectionEnd.column; ++id.column)
             for (id.row = intersectionStart.row; id.row <= intersectionEnd.row; ++id.row)
             {
                 GridID idNew = id - newIdStart;
-                GridID idOld = id - m_idStart;
-                auto& oldCacheItem = m_items[idOld.row * oldIdColumns + idOld.column];
+                auto& oldCacheItem = m_items[itemIndex(id)];
                 auto& newCacheItem = newItems[idNew.row * newIdColumns + idNew.column];
                 newCacheItem.swap(oldCacheItem);
                 newCacheItem->correctRectangles(m_scrollDelta);
             }
+
+        // keep items left the window for reuse
+        for (auto& oldCacheItem : m_items)
+        {
+            if (oldCacheItem)
+                m_itemsPool.append(std::move(oldCacheItem));
+        }
     }
 
     // initialize non-intersected cells
@@ -168,7 +229,13 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
             if (cacheItem)
                 continue;
 
-            cacheItem = createCacheItem(ID(idVisible));
+            if (m_itemsPool.isEmpty())
+                cacheItem = createCacheItem(ID(idVisible));
+            else
+            {
+                cacheItem = m_itemsPool.takeLast();
+                resetCacheItem(*cacheItem, ID(idVisible));
+            }
             // correct rectangle
             cacheItem->rect.translate(origin);
         }
@@ -177,6 +244,12 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
     m_idStart.swap(newIdStart);
     m_idEnd.swap(newIdEnd);
     m_items.swap(newItems);
+    // new items are laid out from the ring beginning
+    m_ringOrigin = GridID(0, 0);
+
+    // don't hold more spare items than the window has
+    if (m_itemsPool.size() > m_items.size())
+        m_itemsPool.resize(m_items.size());
 
     // clear offset
     m_scrollDelta = QPoint(0, 0);
@@ -187,11 +260,55 @@ void CacheSpaceGrid::validateItemsCacheImpl() const
 
 bool CacheSpaceGrid::forEachCacheItemImpl(const std::function<bool (const SharedPtr<CacheItem> &)> &visitor) const
 {
-    for (const auto& cacheItem : m_items)
+    if (m_items.isEmpty())
+        return true;
+
+    // visit items in visible order
+    int idRows = m_idEnd.row - m_idStart.row + 1;
+    int idColumns = m_idEnd.column - m_idStart.column + 1;
+    for (int row = 0; row < idRows; ++row)
     {
-        if (!visitor(cacheItem))
+        int ringRow = m_ringOrigin.row + row;
+        if (ringRow >= idRows)
+            ringRow -= idRows;
+
+        for (int column = 0; column < idColumns; ++column)
+        {
+            int ringColumn = m_ringOrigin.column + column;
+            if (ringColumn >= idColumns)
+                ringColumn -= idColumns;
+
+            if (!visitor(m_items[ringRow * idColumns + ringColumn]))
+                return false;
+        }
+    }
+    return true;
+}
+
+bool CacheSpaceGrid::forEachChangedCacheItemImpl(const ChangedItems& items, const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const
+{
+    // scan cache items if there are too many ids or a range
+    if (!items.range.isNull() || items.ids.size() > m_items.size())
+        return CacheSpace::forEachChangedCacheItemImpl(items, visitor);
+
+    if (m_items.isEmpty())
+        return true;
+
+    for (const auto& item : items.ids)
+    {
+        // look up cache item by visible id
+        GridID visibleId = m_grid->toGridVisible(item.as<GridID>());
+        if (!visibleId.isValid())
+            continue;
+
+        if (visibleId.row < m_idStart.row || visibleId.row > m_idEnd.row ||
+            visibleId.column < m_idStart.column || visibleId.column > m_idEnd.column)
+            continue;
+
+        if (!visitor(m_items[itemIndex(visibleId)]))
             return false;
     }
+
     return true;
 }
 
@@ -202,9 +319,7 @@ const CacheItem* CacheSpaceGrid::cacheItemImpl(ID visibleId) const
     if (!isItemInFrame(visId))
         return nullptr;
 
-    int idColumns = m_idEnd.column - m_idStart.column + 1;
-    auto id = visId - m_idStart;
-    int index = id.row * idColumns + id.column;
+    int index = itemIndex(visId);
     Q_ASSERT(index < m_items.size());
     return m_items[index].data();
 }
@@ -225,4 +340,20 @@ const CacheItem* CacheSpaceGrid::cacheItemByPositionImpl(QPoint point) const
     return cacheItem(ID(visibleId));
 }
 
+int CacheSpaceGrid::itemIndex(GridID visibleId) const
+{
+    int idRows = m_idEnd.row - m_idStart.row + 1;
+    int idColumns = m_idEnd.column - m_idStart.column + 1;
+
+    int ringRow = visibleId.row - m_idStart.row + m_ringOrigin.row;
+    if (ringRow >= idRows)
+        ringRow -= idRows;
+
+    int ringColumn = visibleId.column - m_idStart.column + m_ringOrigin.column;
+    if (ringColumn >= idColumns)
+        ringColumn -= idColumns;
+
+    return ringRow * idColumns + ringColumn;
+}
+
 } // end namespace Qi
@@ -46,17 +46,27 @@ private:
     void clearItemsCacheImpl() const override;
     void validateItemsCacheImpl() const override;
     bool forEachCacheItemImpl(const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const override;
+    bool forEachChangedCacheItemImpl(const ChangedItems& items, const std::function<bool(const SharedPtr<CacheItem>&)>& visitor) const override;
     const CacheItem* cacheItemImpl(ID visibleId) const override;
     const CacheItem* cacheItemByPositionImpl(QPoint point) const override;
 
+    // index of the item in ring storage, visibleId should be in frame
+    int itemIndex(GridID visibleId) const;
+
     // source grid space
     SharedPtr<SpaceGrid> m_grid;
 
     // visible item ids
     mutable GridID m_idStart;
     mutable GridID m_idEnd;
-    // caches items
+    // caches items in ring storage
+    // item m_idStart is stored at m_ringOrigin position
     mutable QVector<SharedPtr<CacheItem>> m_items;
+    mutable GridID m_ringOrigin = GridID(0, 0);
+    // items array for the next validation, reused to avoid reallocations
+    mutable QVector<SharedPtr<CacheItem>> m_newItems;
+    // items left the window, recycled for items entering it
+    mutable QVector<SharedPtr<CacheItem>> m_itemsPool;
 };
 
 } // end namespace Qi 
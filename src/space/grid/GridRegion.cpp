@@ -0,0 +1,111 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "GridRegion.h"
+#include <algorithm>
+
+namespace Qi
+{
+
+bool GridRegion::contains(GridID id) const
+{
+    // first band which begins after the row
+    auto it = std::upper_bound(m_bands.begin(), m_bands.end(), id.row, [](int row, const Band& band) {
+        return row < band.rowBegin;
+    });
+
+    if (it == m_bands.begin())
+        return false;
+
+    --it;
+    return id.row < it->rowEnd && it->columns.contains(id.column);
+}
+
+void GridRegion::apply(const IntervalSet& rows, const IntervalSet& columns, bool unite)
+{
+    if (rows.isEmpty() || columns.isEmpty())
+        return;
+
+    if (!unite && m_bands.isEmpty())
+        return;
+
+    // collect row boundaries of bands and new rows
+    QVector<int> boundaries;
+    boundaries.reserve(2 * (m_bands.size() + rows.intervals().size()));
+    for (const auto& band : m_bands)
+    {
+        boundaries.append(band.rowBegin);
+        boundaries.append(band.rowEnd);
+    }
+    for (const auto& interval : rows.intervals())
+    {
+        boundaries.append(interval.begin);
+        boundaries.append(interval.end);
+    }
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    QVector<Band> result;
+    result.reserve(m_bands.size() + rows.intervals().size());
+
+    const auto& rowIntervals = rows.intervals();
+    int bandIndex = 0;
+    int rowIndex = 0;
+    for (int i = 0; i + 1 < boundaries.size(); ++i)
+    {
+        int segmentBegin = boundaries[i];
+        int segmentEnd = boundaries[i + 1];
+
+        // segments never cross any boundary, so check their begin only
+        while (bandIndex < m_bands.size() && m_bands[bandIndex].rowEnd <= segmentBegin)
+            ++bandIndex;
+        while (rowIndex < rowIntervals.size() && rowIntervals[rowIndex].end <= segmentBegin)
+            ++rowIndex;
+
+        bool inBand = bandIndex < m_bands.size() && m_bands[bandIndex].rowBegin <= segmentBegin;
+        bool inRows = rowIndex < rowIntervals.size() && rowIntervals[rowIndex].begin <= segmentBegin;
+
+        IntervalSet segmentColumns;
+        if (inBand)
+            segmentColumns = m_bands[bandIndex].columns;
+
+        if (inRows)
+        {
+            if (unite)
+                segmentColumns.unite(columns);
+            else
+                segmentColumns.subtract(columns);
+        }
+
+        if (segmentColumns.isEmpty())
+            continue;
+
+        // merge with previous band if it has the same columns
+        if (!result.isEmpty() && result.last().rowEnd == segmentBegin && result.last().columns == segmentColumns)
+        {
+            result.last().rowEnd = segmentEnd;
+        }
+        else
+        {
+            Band band = { segmentBegin, segmentEnd, std::move(segmentColumns) };
+            result.append(std::move(band));
+        }
+    }
+
+    m_bands.swap(result);
+}
+
+} // end namespace Qi
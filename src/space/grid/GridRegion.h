@@ -0,0 +1,60 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_GRID_REGION_H
+#define QI_GRID_REGION_H
+
+#include "GridID.h"
+#include "utils/IntervalSet.h"
+
+namespace Qi
+{
+
+// set of grid cells stored as sorted disjoint row bands
+// each band keeps the same set of columns for all its rows
+class QI_EXPORT GridRegion
+{
+public:
+    struct Band
+    {
+        int rowBegin;
+        int rowEnd;
+        IntervalSet columns;
+    };
+
+    GridRegion() = default;
+
+    bool isEmpty() const { return m_bands.isEmpty(); }
+    void clear() { m_bands.clear(); }
+
+    const QVector<Band>& bands() const { return m_bands; }
+
+    bool contains(GridID id) const;
+    bool contains(int row, int column) const { return contains(GridID(row, column)); }
+
+    // adds or removes cells rows x columns
+    void unite(const IntervalSet& rows, const IntervalSet& columns) { apply(rows, columns, true); }
+    void subtract(const IntervalSet& rows, const IntervalSet& columns) { apply(rows, columns, false); }
+
+private:
+    void apply(const IntervalSet& rows, const IntervalSet& columns, bool unite);
+
+    QVector<Band> m_bands;
+};
+
+} // end namespace Qi
+
+#endif // QI_GRID_REGION_H
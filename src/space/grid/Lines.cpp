@@ -23,7 +23,9 @@ static const int DefaultLineSize = 0;
 static const bool DefaultLineVisibility = true;
 
 Lines::Lines(int count)
-    : m_count(0)
+    : m_count(0),
+      m_hasFreeSlots(false),
+      m_visibleMappingMisses(0)
 {
     setCount(count);
 }
@@ -34,9 +36,15 @@ Lines::Lines(const Lines& lines)
       m_linesSize(lines.m_linesSize),
       m_linesVisible(lines.m_linesVisible),
       m_relative2absolute(lines.m_relative2absolute),
+      m_hasFreeSlots(lines.m_hasFreeSlots),
       m_visible2absolute(lines.m_visible2absolute),
       m_absolute2visible(lines.m_absolute2visible),
-      m_visibleLinesSizes(lines.m_visibleLinesSizes)
+      m_visibleMappingMisses(lines.m_visibleMappingMisses),
+      m_linesVisibleCache(lines.m_linesVisibleCache),
+      m_visibleLinesSizes(lines.m_visibleLinesSizes),
+      m_visibleLinesCount(lines.m_visibleLinesCount),
+      m_absolute2relative(lines.m_absolute2relative),
+      m_slotLines(lines.m_slotLines)
 {
 }
 
@@ -81,6 +89,7 @@ void Lines::setCount(int _count)
     m_relative2absolute.resize(count);
     for (int i = 0; i < count; ++i)
         m_relative2absolute[i] = i;
+    m_hasFreeSlots = false;
 
     // invalidate caches
     invalidateVisibles();
@@ -133,6 +142,8 @@ int Lines::moveLines(int oldAbsoluteLine, int newRelativeLine, int linesCount)
     if (oldAbsoluteLine >= count())
         return InvalidIndex;
 
+    compactSlots();
+
     // convert absolute line to relative line
     int oldLine = (int)std::distance(m_relative2absolute.begin(), std::find(m_relative2absolute.begin(), m_relative2absolute.end(), oldAbsoluteLine));
     int newLine = newRelativeLine;
@@ -143,7 +154,7 @@ int Lines::moveLines(int oldAbsoluteLine, int newRelativeLine, int linesCount)
 
     int index = moveValues(m_relative2absolute, oldLine, newLine, linesCount);
 
-    invalidateVisibles();
+    invalidatePositions();
 
     emit linesChanged(this, ChangeReasonLinesOrder);
 
@@ -157,13 +168,15 @@ int Lines::moveVisibleLines(int oldLine, int newLine, int linesCount)
     if (((oldLine + linesCount) > count()) || (newLine > count()) || (newLine > oldLine && newLine < (oldLine + linesCount)))
         return InvalidIndex;
 
+    compactSlots();
+
     // convert visible lines to relative lines
     oldLine = (int)std::distance(m_relative2absolute.begin(), std::find(m_relative2absolute.begin(), m_relative2absolute.end(), toAbsolute(oldLine)));
     newLine = (int)std::distance(m_relative2absolute.begin(), std::find(m_relative2absolute.begin(), m_relative2absolute.end(), toAbsolute(newLine)));
 
     int index = moveValues(m_relative2absolute, oldLine, newLine, linesCount);
 
-    invalidateVisibles();
+    invalidatePositions();
 
     emit linesChanged(this, ChangeReasonLinesOrder);
 
@@ -195,101 +208,326 @@ int Lines::findVisibleIDByPos(int position, bool noTailLine) const
     if (position <= 0)
         return 0;
 
-    if (position > endPos(visibleCount() - 1))
+    if (position > visibleSize())
         return noTailLine ? visibleCount() - 1 : visibleCount();
 
-    validateSizes();
-    return findVisibleIDByPosImpl(position, 0, visibleCount() - 1);
+    return findVisibleIDByPosImpl(position);
 }
 
 int Lines::findVisibleIDByPos(int position, int fromVisibleLine, int toVisibleLine) const
 {
     Q_ASSERT(fromVisibleLine < m_count && toVisibleLine < m_count && fromVisibleLine <= toVisibleLine);
 
-    validateSizes();
-
-    if (position < m_visibleLinesSizes[fromVisibleLine])
+    if (position < startPos(fromVisibleLine))
         return InvalidIndex;
-    else if (position > m_visibleLinesSizes[toVisibleLine + 1])
+    else if (position > endPos(toVisibleLine))
         return InvalidIndex;
     else
-        return findVisibleIDByPosImpl(position, fromVisibleLine, toVisibleLine);
+        return qMin(findVisibleIDByPosImpl(position), toVisibleLine);
 }
 
-int Lines::findVisibleIDByPosImpl(int position, int fromVisibleLine, int toVisibleLine) const
+int Lines::findVisibleIDByPosImpl(int position) const
 {
-    Q_ASSERT(fromVisibleLine < m_count && toVisibleLine < m_count && fromVisibleLine <= toVisibleLine);
+    validatePositions();
 
-    if (fromVisibleLine == toVisibleLine)
-    {
-        return fromVisibleLine;
-    }
-    else if ((toVisibleLine - fromVisibleLine) == 1)
+    // relative lines [0, relativeCount) start at or before the position
+    int relativeCount = qMin(m_visibleLinesSizes.findPrefix(position) + 1, slotsCount());
+    // the last visible line among them
+    return m_visibleLinesCount.prefixSum(relativeCount) - 1;
+}
+
+int Lines::toAbsoluteIndexed(int visibleLine) const
+{
+    validatePositions();
+    return m_relative2absolute[toRelative(visibleLine)];
+}
+
+int Lines::toVisibleIndexed(int absoluteLine) const
+{
+    validatePositions();
+
+    int relativeLine = m_absolute2relative[absoluteLine];
+    if (!m_visibleLinesCount.value(relativeLine))
+        return InvalidIndex;
+
+    return m_visibleLinesCount.prefixSum(relativeLine);
+}
+
+void Lines::validateVisibleCache() const
+{
+    if (isVisibleCacheValid())
+        return;
+
+    m_linesVisibleCache.resize(m_count);
+    for (int line = 0; line < m_count; ++line)
+        m_linesVisibleCache[line] = isLineVisibleRaw(line);
+
+    // evaluate filters line range at once
+    for (const auto& linesVisibility: m_linesVisibility)
+        linesVisibility->filterLinesVisible(0, m_count, m_linesVisibleCache);
+}
+
+bool Lines::validateVisibles() const
+{
+    if (isVisibleMappingValid())
+        return true;
+
+    validatePositions();
+    if (isVisibleMappingValid())
+        return true;
+
+    // mapping arrays were dropped by incremental visibility changes,
+    // rebuild them only when enough lookups have been served by positions index
+    // to pay for the linear pass
+    if (m_visibleMappingMisses < m_count / 8)
     {
-        if (position < m_visibleLinesSizes[toVisibleLine])
-            return fromVisibleLine;
-        else
-            return toVisibleLine;
+        ++m_visibleMappingMisses;
+        return false;
     }
 
-    Q_ASSERT(position >= m_visibleLinesSizes[fromVisibleLine]);
+    buildVisibleMapping();
+    return true;
+}
 
-    int middleLine = (fromVisibleLine + toVisibleLine) / 2;
-    if (position < m_visibleLinesSizes[middleLine])
+void Lines::buildVisibleMapping() const
+{
+    Q_ASSERT(isPositionsValid());
+
+    m_visible2absolute.clear();
+    m_visible2absolute.reserve(m_visibleLinesCount.totalSum());
+    m_absolute2visible.fill(InvalidIndex, m_count);
+    for (int relativeLine = 0; relativeLine < slotsCount(); ++relativeLine)
     {
-        return findVisibleIDByPosImpl(position, fromVisibleLine, middleLine);
+        int absoluteLine = m_relative2absolute[relativeLine];
+        if (absoluteLine != InvalidIndex && m_linesVisibleCache[absoluteLine])
+        {
+            m_absolute2visible[absoluteLine] = m_visible2absolute.size();
+            m_visible2absolute.append(absoluteLine);
+        }
     }
-    else
+
+    m_visibleMappingMisses = 0;
+}
+
+void Lines::validatePositions() const
+{
+    if (isPositionsValid())
+        return;
+
+    validateVisibleCache();
+
+    QVector<int> sizes(slotsCount());
+    QVector<int> visibles(slotsCount());
+    m_absolute2relative.resize(m_count);
+
+    for (int relativeLine = 0; relativeLine < slotsCount(); ++relativeLine)
     {
-        return findVisibleIDByPosImpl(position, middleLine, toVisibleLine);
+        int absoluteLine = m_relative2absolute[relativeLine];
+        if (absoluteLine == InvalidIndex)
+            continue;
+
+        m_absolute2relative[absoluteLine] = relativeLine;
+
+        if (m_linesVisibleCache[absoluteLine])
+        {
+            visibles[relativeLine] = 1;
+            sizes[relativeLine] = lineSize(absoluteLine);
+        }
     }
+
+    m_visibleLinesSizes.assign(sizes);
+    m_visibleLinesCount.assign(visibles);
+
+    // full rebuild is linear anyway, so refresh mapping arrays too
+    buildVisibleMapping();
 }
 
-void Lines::validateVisibles() const
+void Lines::updateLineVisible(int line)
 {
-    if (!m_absolute2visible.empty())
+    if (!isVisibleCacheValid())
         return;
 
-    m_visible2absolute.clear();
-    m_absolute2visible.fill(InvalidIndex, m_relative2absolute.size());
-    for (int i = 0, count = m_relative2absolute.size(); i < count; ++i)
+    bool isVisible = evaluateLineVisible(line);
+    if (m_linesVisibleCache[line] == isVisible)
+        return;
+
+    m_linesVisibleCache[line] = isVisible;
+    invalidateVisibleMapping();
+
+    if (!isPositionsValid())
+        return;
+
+    int relativeLine = m_absolute2relative[line];
+    m_visibleLinesCount.setValue(relativeLine, isVisible ? 1 : 0);
+    m_visibleLinesSizes.setValue(relativeLine, isVisible ? lineSize(line) : 0);
+}
+
+void Lines::updateLineSize(int line)
+{
+    if (!isPositionsValid() || !m_linesVisibleCache[line])
+        return;
+
+    m_visibleLinesSizes.setValue(m_absolute2relative[line], lineSize(line));
+}
+
+void Lines::compactSlots() const
+{
+    if (!m_hasFreeSlots)
+        return;
+
+    m_relative2absolute.erase(std::remove(m_relative2absolute.begin(), m_relative2absolute.end(), InvalidIndex), m_relative2absolute.end());
+    m_hasFreeSlots = false;
+    invalidatePositions();
+}
+
+void Lines::validateSlots() const
+{
+    validatePositions();
+
+    if (m_slotLines.size() == slotsCount())
+        return;
+
+    QVector<int> slotLines(slotsCount());
+    for (int relativeLine = 0; relativeLine < slotsCount(); ++relativeLine)
+        slotLines[relativeLine] = (m_relative2absolute[relativeLine] != InvalidIndex) ? 1 : 0;
+    m_slotLines.assign(slotLines);
+}
+
+// free slot is left after every SlotsGap lines
+static const int SlotsGap = 8;
+// lines are shifted towards free slot not further than MaxSlotsShift slots
+static const int MaxSlotsShift = 64;
+
+void Lines::spreadSlots() const
+{
+    QVector<int> spread;
+    spread.reserve(m_count + m_count / SlotsGap + 1);
+    int linesInRun = 0;
+    for (int line : m_relative2absolute)
     {
-        int absoluteLine = m_relative2absolute[i];
-        if (isLineVisible(absoluteLine))
+        if (line == InvalidIndex)
+            continue;
+
+        spread.append(line);
+        if (++linesInRun == SlotsGap)
         {
-            m_visible2absolute.append(absoluteLine);
-            m_absolute2visible[absoluteLine] = m_visible2absolute.size() - 1;
+            spread.append(InvalidIndex);
+            linesInRun = 0;
         }
     }
+    if (linesInRun > 0)
+        spread.append(InvalidIndex);
+
+    m_relative2absolute.swap(spread);
+    m_hasFreeSlots = true;
+    invalidatePositions();
+    validateSlots();
 }
 
-void Lines::validateSizes() const
+void Lines::removeFromSlot(int line)
 {
-    if (!m_visibleLinesSizes.empty())
-        return;
+    int slot = m_absolute2relative[line];
+    Q_ASSERT(m_relative2absolute[slot] == line);
 
-    validateVisibles();
+    m_relative2absolute[slot] = InvalidIndex;
+    m_absolute2relative[line] = InvalidIndex;
+    m_hasFreeSlots = true;
 
-    int size = 0;
-    m_visibleLinesSizes.resize(visibleCount() + 1);
+    m_slotLines.setValue(slot, 0);
+    m_visibleLinesCount.setValue(slot, 0);
+    m_visibleLinesSizes.setValue(slot, 0);
+    invalidateVisibleMapping();
+}
 
-    for (int line = 0; line < m_visibleLinesSizes.size() - 1; ++line)
+void Lines::insertToSlot(int line, int order)
+{
+    for (;;)
     {
-        m_visibleLinesSizes[line] = size;
-        size += lineSize(toAbsolute(line));
+        int linesCount = m_slotLines.totalSum();
+        // line should be placed in a free slot between previous and next lines
+        int prevSlot = (order > 0) ? m_slotLines.findPrefix(order - 1) : -1;
+        int nextSlot = (order < linesCount) ? m_slotLines.findPrefix(order) : slotsCount();
+
+        if (nextSlot - prevSlot > 1)
+        {
+            placeToSlot(line, prevSlot + 1);
+            return;
+        }
+
+        // shift next lines towards the nearest free slot on the right
+        for (int slot = nextSlot + 1, end = qMin(nextSlot + MaxSlotsShift, slotsCount()); slot < end; ++slot)
+        {
+            if (m_relative2absolute[slot] == InvalidIndex)
+            {
+                for (; slot > nextSlot; --slot)
+                    moveSlot(slot - 1, slot);
+                placeToSlot(line, nextSlot);
+                return;
+            }
+        }
+
+        // shift previous lines towards the nearest free slot on the left
+        for (int slot = prevSlot - 1, end = qMax(prevSlot - MaxSlotsShift, -1); slot > end; --slot)
+        {
+            if (m_relative2absolute[slot] == InvalidIndex)
+            {
+                for (; slot < prevSlot; ++slot)
+                    moveSlot(slot + 1, slot);
+                placeToSlot(line, prevSlot);
+                return;
+            }
+        }
+
+        // no free slots nearby, redistribute them in O(n)
+        spreadSlots();
     }
-    m_visibleLinesSizes.back() = size;
 }
 
+void Lines::placeToSlot(int line, int slot)
+{
+    Q_ASSERT(m_relative2absolute[slot] == InvalidIndex);
+
+    m_relative2absolute[slot] = line;
+    m_absolute2relative[line] = slot;
+
+    bool isVisible = m_linesVisibleCache[line];
+    m_slotLines.setValue(slot, 1);
+    m_visibleLinesCount.setValue(slot, isVisible ? 1 : 0);
+    m_visibleLinesSizes.setValue(slot, isVisible ? lineSize(line) : 0);
+    invalidateVisibleMapping();
+}
+
+void Lines::moveSlot(int fromSlot, int toSlot)
+{
+    int line = m_relative2absolute[fromSlot];
+
+    m_relative2absolute[fromSlot] = InvalidIndex;
+    m_slotLines.setValue(fromSlot, 0);
+    m_visibleLinesCount.setValue(fromSlot, 0);
+    m_visibleLinesSizes.setValue(fromSlot, 0);
+
+    placeToSlot(line, toSlot);
+}
 
 void Lines::setLinesVisible(const QVector<int>& lines, bool visible)
 {
+    if (m_linesVisible.size() <= 1)
+    {
+        // make explicit copy of front
+        bool visibility = m_linesVisible.empty() ? DefaultLineVisibility : m_linesVisible.front();
+        m_linesVisible.fill(visibility, m_count);
+    }
+
     for (auto line: lines)
     {
+        Q_ASSERT(line < m_count);
+        if (m_linesVisible[line] == visible)
+            continue;
+
         m_linesVisible[line] = visible;
+        updateLineVisible(line);
     }
 
-    invalidateVisibles();
     emit linesChanged(this, ChangeReasonLinesVisibility);
 }
 
@@ -337,7 +575,7 @@ void Lines::setLineSize(int line, int size)
     if (m_linesSize[line] != size)
     {
         m_linesSize[line] = size;
-        invalidateSizes();
+        updateLineSize(line);
         emit linesChanged(this, ChangeReasonLinesSize);
     }
 }
@@ -347,7 +585,7 @@ void Lines::setLineSizeAll(int size)
     Q_ASSERT(size >= 0);
     m_linesSize.fill(size, 1);
 
-    invalidateSizes();
+    invalidatePositions();
     emit linesChanged(this, ChangeReasonLinesSize);
 }
 
@@ -364,6 +602,14 @@ bool Lines::isLineVisibleRaw(int line) const
 }
 
 bool Lines::isLineVisible(int line) const
+{
+    if (isVisibleCacheValid())
+        return m_linesVisibleCache[line];
+
+    return evaluateLineVisible(line);
+}
+
+bool Lines::evaluateLineVisible(int line) const
 {
     if (!isLineVisibleRaw(line))
         return false;
@@ -428,7 +674,7 @@ void Lines::setLineVisible(int line, bool visible)
     if (m_linesVisible[line] != visible)
     {
         m_linesVisible[line] = visible;
-        invalidateVisibles();
+        updateLineVisible(line);
         emit linesChanged(this, ChangeReasonLinesVisibility);
     }
 }
@@ -447,6 +693,7 @@ bool Lines::addLinesVisibility(SharedPtr<LinesVisibility> linesVisibility)
         return false;
 
     connect(linesVisibility.data(), &LinesVisibility::visibilityChanged, this, &Lines::onLinesVisibilityChanged);
+    connect(linesVisibility.data(), &LinesVisibility::linesVisibilityChanged, this, &Lines::onLinesVisibilityLinesChanged);
     m_linesVisibility.append(std::move(linesVisibility));
 
     invalidateVisibles();
@@ -463,6 +710,7 @@ bool Lines::removeLinesVisibility(SharedPtr<LinesVisibility> linesVisibility)
 
     m_linesVisibility.erase(it);
     disconnect(linesVisibility.data(), &LinesVisibility::visibilityChanged, this, &Lines::onLinesVisibilityChanged);
+    disconnect(linesVisibility.data(), &LinesVisibility::linesVisibilityChanged, this, &Lines::onLinesVisibilityLinesChanged);
 
     invalidateVisibles();
     emit linesChanged(this, ChangeReasonLinesVisibility);
@@ -475,6 +723,7 @@ void Lines::clearLinesVisibility()
     for (const auto& linesVisibility: m_linesVisibility)
     {
         disconnect(linesVisibility.data(), &LinesVisibility::visibilityChanged, this, &Lines::onLinesVisibilityChanged);
+        disconnect(linesVisibility.data(), &LinesVisibility::linesVisibilityChanged, this, &Lines::onLinesVisibilityLinesChanged);
     }
     m_linesVisibility.clear();
 
@@ -488,36 +737,59 @@ void Lines::onLinesVisibilityChanged(const LinesVisibility*)
     emit linesChanged(this, ChangeReasonLinesVisibility);
 }
 
+void Lines::onLinesVisibilityLinesChanged(const LinesVisibility*, const QVector<int>& lines)
+{
+    for (auto line: lines)
+    {
+        if (line >= 0 && line < m_count)
+            updateLineVisible(line);
+    }
+
+    emit linesChanged(this, ChangeReasonLinesVisibility);
+}
+
 int Lines::visibleCount() const
 {
-    validateVisibles();
-    return m_visible2absolute.size();
+    validatePositions();
+    return m_visibleLinesCount.totalSum();
 }
 
 int Lines::visibleSize() const
 {
-    validateSizes();
-    return m_visibleLinesSizes.back();
+    validatePositions();
+    return m_visibleLinesSizes.totalSum();
 }
 
 int Lines::startPos(int visibleLine) const
 {
-    validateSizes();
-    return m_visibleLinesSizes[visibleLine];
+    validatePositions();
+    return m_visibleLinesSizes.prefixSum(toRelative(visibleLine));
 }
 
 int Lines::endPos(int visibleLine) const
 {
-    validateSizes();
-    return m_visibleLinesSizes[visibleLine + 1];
+    validatePositions();
+    return m_visibleLinesSizes.prefixSum(toRelative(visibleLine) + 1);
 }
 
 void Lines::setPermutation(const QVector<int>& permutation)
 {
     Q_ASSERT(permutation.size() == count());
     m_relative2absolute = permutation;
-    invalidateVisibles();
+    m_hasFreeSlots = false;
+    invalidatePositions();
     emit linesChanged(this, ChangeReasonLinesOrder);
 }
 
+void LinesVisibility::filterLinesVisibleImpl(int beginLine, int endLine, QVector<bool>& visible) const
+{
+    Q_ASSERT(beginLine >= 0 && endLine <= visible.size());
+
+    for (int line = beginLine; line < endLine; ++line)
+    {
+        if (visible[line] && !isLineVisibleImpl(line))
+            visible[line] = false;
+    }
+}
+
 } // end namespace Qi
@@ -18,8 +18,11 @@
 #define QI_LINES_H
 
 #include "QiAPI.h"
+#include "utils/FenwickTree.h"
+#include "utils/ParallelSort.h"
 #include <QObject>
 #include <QVector>
+#include <QSet>
 #include <functional>
 
 namespace Qi
@@ -68,11 +71,11 @@ public:
     int moveVisibleLines(int oldLine, int newLine, int linesCount = 1);
     int insertVisibleLines(int lineBefore, int linesCount = 1);
 
-    int toAbsolute(int visibleLine) const { validateVisibles(); Q_ASSERT(visibleLine >= 0 && visibleLine < m_visible2absolute.size()); return m_visible2absolute[visibleLine]; }
-    int toVisible(int absoluteLine) const { validateVisibles(); Q_ASSERT(absoluteLine >= 0 && absoluteLine < m_absolute2visible.size()); return m_absolute2visible[absoluteLine]; }
+    int toAbsolute(int visibleLine) const { Q_ASSERT(visibleLine >= 0 && visibleLine < visibleCount()); return validateVisibles() ? m_visible2absolute[visibleLine] : toAbsoluteIndexed(visibleLine); }
+    int toVisible(int absoluteLine) const { Q_ASSERT(absoluteLine >= 0 && absoluteLine < m_count); return validateVisibles() ? m_absolute2visible[absoluteLine] : toVisibleIndexed(absoluteLine); }
 
-    int toAbsoluteSafe(int visibleLine) const { validateVisibles(); return (visibleLine < m_visible2absolute.size()) ? m_visible2absolute[visibleLine] : InvalidIndex; }
-    int toVisibleSafe(int absoluteLine) const { validateVisibles(); return (absoluteLine < m_absolute2visible.size()) ? m_absolute2visible[absoluteLine] : InvalidIndex; }
+    int toAbsoluteSafe(int visibleLine) const { return (visibleLine >= 0 && visibleLine < visibleCount()) ? toAbsolute(visibleLine) : InvalidIndex; }
+    int toVisibleSafe(int absoluteLine) const { return (absoluteLine >= 0 && absoluteLine < m_count) ? toVisible(absoluteLine) : InvalidIndex; }
 
     // see m_visibleLinesSizes for possible return values
     int findVisibleIDByPos(int position, bool noTailLine = true) const;
@@ -82,19 +85,70 @@ public:
     int endPos(int visibleLine) const;
 
     // pred has less operator - bool operator() (int leftLine, int rightLine) const;
-    template <typename Pred> void sort(bool stable, const Pred& pred)
+    // parallel sort is always stable and calls pred from several threads
+    template <typename Pred> void sort(bool stable, const Pred& pred, bool parallel = false)
     {
-        if (stable)
+        compactSlots();
+
+        if (parallel)
+            parallelStableSort(m_relative2absolute, pred);
+        else if (stable)
             std::stable_sort(m_relative2absolute.begin(), m_relative2absolute.end(), pred);
         else
             std::sort(m_relative2absolute.begin(), m_relative2absolute.end(), pred);
 
-        invalidateVisibles();
+        invalidatePositions();
+        emit linesChanged(this, ChangeReasonLinesOrder);
+    }
+
+    // moves lines to their places in permutation already sorted by pred
+    // only moved lines are removed and inserted back into free slots,
+    // pred is called O(lines.size() * log(count())) times
+    template <typename Pred> void resort(const QVector<int>& lines, const Pred& pred)
+    {
+        QVector<int> movedLines;
+        QSet<int> uniqueLines;
+        for (int line : lines)
+        {
+            Q_ASSERT(line >= 0 && line < m_count);
+            if (!uniqueLines.contains(line))
+            {
+                uniqueLines.insert(line);
+                movedLines.append(line);
+            }
+        }
+
+        if (movedLines.isEmpty())
+            return;
+
+        std::stable_sort(movedLines.begin(), movedLines.end(), pred);
+
+        validateSlots();
+        for (int line : movedLines)
+            removeFromSlot(line);
+
+        // moved lines go after equal lines
+        for (int line : movedLines)
+        {
+            int first = 0;
+            int last = m_slotLines.totalSum();
+            while (first < last)
+            {
+                int middle = (first + last) / 2;
+                if (pred(line, lineByOrder(middle)))
+                    last = middle;
+                else
+                    first = middle + 1;
+            }
+
+            insertToSlot(line, first);
+        }
+
         emit linesChanged(this, ChangeReasonLinesOrder);
     }
 
     // permutation[relativeID] == absoluteID
-    const QVector<int>& permutation() const { return m_relative2absolute; }
+    const QVector<int>& permutation() const { compactSlots(); return m_relative2absolute; }
     void setPermutation(const QVector<int>& permutation);
 
 signals:
@@ -105,16 +159,51 @@ private:
     Lines& operator=(const Lines&);
 
     bool isLineVisibleRaw(int line) const;
-
-    int findVisibleIDByPosImpl(int position, int fromVisibleLine, int toVisibleLine) const;
-
-    void invalidateVisibles() { m_visible2absolute.clear(); m_absolute2visible.clear(); invalidateSizes(); }
-    void validateVisibles() const;
-
-    void invalidateSizes() { m_visibleLinesSizes.clear(); }
-    void validateSizes() const;
+    bool evaluateLineVisible(int line) const;
+
+    int findVisibleIDByPosImpl(int position) const;
+    int toRelative(int visibleLine) const { return m_visibleLinesCount.findPrefix(visibleLine); }
+    int toAbsoluteIndexed(int visibleLine) const;
+    int toVisibleIndexed(int absoluteLine) const;
+
+    // drops everything derived from lines visibility
+    void invalidateVisibles() { m_linesVisibleCache.clear(); invalidatePositions(); }
+    void validateVisibleCache() const;
+    bool isVisibleCacheValid() const { return m_linesVisibleCache.size() == m_count; }
+
+    // drops positions index and visible mapping but keeps cached visibility
+    void invalidatePositions() const { m_visibleLinesSizes.clear(); m_visibleLinesCount.clear(); m_slotLines.clear(); m_absolute2relative.clear(); invalidateVisibleMapping(); }
+    void validatePositions() const;
+    bool isPositionsValid() const { return m_absolute2relative.size() == m_count; }
+
+    // relative lines are slots of m_relative2absolute, resort leaves free slots between lines
+    int slotsCount() const { return m_relative2absolute.size(); }
+    // removes free slots, positions should be rebuilt after that
+    void compactSlots() const;
+    // validates positions and index of occupied slots
+    void validateSlots() const;
+    // rebuilds permutation with a free slot after every few lines
+    void spreadSlots() const;
+    // absolute line placed at order position among all lines
+    int lineByOrder(int order) const { return m_relative2absolute[m_slotLines.findPrefix(order)]; }
+    void removeFromSlot(int line);
+    // places line so it becomes order-th line
+    void insertToSlot(int line, int order);
+    void placeToSlot(int line, int slot);
+    void moveSlot(int fromSlot, int toSlot);
+
+    void invalidateVisibleMapping() const { m_visible2absolute.clear(); m_absolute2visible.clear(); m_visibleMappingMisses = 0; }
+    // returns false if mapping arrays are stale and positions index should be used instead
+    bool validateVisibles() const;
+    bool isVisibleMappingValid() const { return m_absolute2visible.size() == m_count; }
+    void buildVisibleMapping() const;
+
+    // patch cached visibility and positions index for one line in O(log n)
+    void updateLineVisible(int line);
+    void updateLineSize(int line);
 
     void onLinesVisibilityChanged(const LinesVisibility*);
+    void onLinesVisibilityLinesChanged(const LinesVisibility*, const QVector<int>& lines);
 
     // lines count
     int m_count;
@@ -129,16 +218,31 @@ private:
     QVector<bool> m_linesVisible;
 
     // lines permutation (m_indices[relativeLine] = absoluteLine)
+    // free slots have InvalidIndex value
     mutable QVector<int> m_relative2absolute;
+    mutable bool m_hasFreeSlots;
     // m_visible2absolute[visible line] = absolute line
     mutable QVector<int> m_visible2absolute;
     // m_absolute2visible[absolute line] = { visible line | INVALID_INDEX }
     mutable QVector<int> m_absolute2visible;
-
-    // cache for line sizes
-    // m_visibleLinesSizes[line] - start position of the visible line
-    // m_visibleLinesSizes[visibleLineCount] - end position of the last visible line
-    mutable QVector<int> m_visibleLinesSizes;
+    // lookups served by positions index since mapping arrays were dropped
+    mutable int m_visibleMappingMisses;
+
+    // m_linesVisibleCache[absolute line] - cached result of isLineVisible
+    mutable QVector<bool> m_linesVisibleCache;
+
+    // positions index, both trees are indexed by relative line
+    // m_visibleLinesSizes[relativeLine] - line size if the line is visible and 0 otherwise
+    // m_visibleLinesSizes.prefixSum(relativeLine) - start position of the line
+    mutable FenwickTree m_visibleLinesSizes;
+    // m_visibleLinesCount[relativeLine] - 1 if the line is visible and 0 otherwise
+    // m_visibleLinesCount.prefixSum(relativeLine) - visible line of the relative line
+    mutable FenwickTree m_visibleLinesCount;
+    // m_absolute2relative[absolute line] = relative line
+    mutable QVector<int> m_absolute2relative;
+    // m_slotLines[relativeLine] - 1 if the slot has a line and 0 otherwise
+    // built on demand by resort
+    mutable FenwickTree m_slotLines;
 
     //
     // lines visibility stuff
@@ -156,14 +260,20 @@ public:
     virtual ~LinesVisibility() {}
 
     bool isLineVisible(int line) const { return isLineVisibleImpl(line); }
+    // clears visible[line] for invisible lines in range [beginLine, endLine)
+    // lines already marked as invisible are not evaluated
+    void filterLinesVisible(int beginLine, int endLine, QVector<bool>& visible) const { filterLinesVisibleImpl(beginLine, endLine, visible); }
 
 signals:
     void visibilityChanged(const LinesVisibility* visibility);
+    // only visibility of listed lines was changed
+    void linesVisibilityChanged(const LinesVisibility* visibility, const QVector<int>& lines);
 
 protected:
     LinesVisibility() {}
 
     virtual bool isLineVisibleImpl(int line) const = 0;
+    virtual void filterLinesVisibleImpl(int beginLine, int endLine, QVector<bool>& visible) const;
 };
 
 class QI_EXPORT LinesVisibilityCallback: public LinesVisibility
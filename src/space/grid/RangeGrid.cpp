@@ -38,28 +38,52 @@ bool RangeGridColumn::hasItemImpl(GridID id) const
     return id.column == m_column;
 }
 
+bool RangeGridColumn::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows = IntervalSet::all();
+    columns = IntervalSet(m_column, m_column + 1);
+    return true;
+}
+
 SharedPtr<RangeGridColumn> makeRangeGridColumn(int column)
 {
     return makeShared<RangeGridColumn>(column);
 }
 
-RangeGridColumns::RangeGridColumns(QSet<int> columns)
+RangeGridColumns::RangeGridColumns(const QSet<int>& columns)
+    : m_columns(IntervalSet::fromSet(columns))
+{
+}
+
+RangeGridColumns::RangeGridColumns(IntervalSet columns)
     : m_columns(std::move(columns))
 {
 }
 
 RangeGridColumns::RangeGridColumns(int columnBegin, int columnEnd)
+    : m_columns(columnBegin, columnEnd)
 {
     Q_ASSERT(columnBegin <= columnEnd);
-    for (int column = columnBegin; column != columnEnd; ++column)
-        m_columns.insert(column);
 }
 
-void RangeGridColumns::setColumns(QSet<int> columns)
+const QSet<int>& RangeGridColumns::columns() const
+{
+    if (!m_isColumnsSetValid)
+    {
+        m_columnsSet = m_columns.toSet();
+        m_isColumnsSetValid = true;
+    }
+
+    return m_columnsSet;
+}
+
+void RangeGridColumns::setColumnIntervals(IntervalSet columns)
 {
     if (m_columns != columns)
     {
         m_columns = std::move(columns);
+        m_columnsSet.clear();
+        m_isColumnsSetValid = false;
         emit rangeChanged(this, ChangeReasonRange);
     }
 }
@@ -69,6 +93,13 @@ bool RangeGridColumns::hasItemImpl(GridID id) const
     return m_columns.contains(id.column);
 }
 
+bool RangeGridColumns::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows = IntervalSet::all();
+    columns = m_columns;
+    return true;
+}
+
 SharedPtr<RangeGridColumns> makeRangeGridColumns(const QSet<int>& columns)
 {
     return makeShared<RangeGridColumns>(columns);
@@ -98,28 +129,52 @@ bool RangeGridRow::hasItemImpl(GridID id) const
     return id.row == m_row;
 }
 
+bool RangeGridRow::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows = IntervalSet(m_row, m_row + 1);
+    columns = IntervalSet::all();
+    return true;
+}
+
 SharedPtr<RangeGridRow> makeRangeGridRow(int row)
 {
     return makeShared<RangeGridRow>(row);
 }
 
-RangeGridRows::RangeGridRows(QSet<int> rows)
+RangeGridRows::RangeGridRows(const QSet<int>& rows)
+    : m_rows(IntervalSet::fromSet(rows))
+{
+}
+
+RangeGridRows::RangeGridRows(IntervalSet rows)
     : m_rows(std::move(rows))
 {
 }
 
 RangeGridRows::RangeGridRows(int rowBegin, int rowEnd)
+    : m_rows(rowBegin, rowEnd)
 {
     Q_ASSERT(rowBegin <= rowEnd);
-    for (int row = rowBegin; row != rowEnd; ++row)
-        m_rows.insert(row);
 }
 
-void RangeGridRows::setRows(QSet<int> rows)
+const QSet<int>& RangeGridRows::rows() const
+{
+    if (!m_isRowsSetValid)
+    {
+        m_rowsSet = m_rows.toSet();
+        m_isRowsSetValid = true;
+    }
+
+    return m_rowsSet;
+}
+
+void RangeGridRows::setRowIntervals(IntervalSet rows)
 {
     if (m_rows != rows)
     {
         m_rows = std::move(rows);
+        m_rowsSet.clear();
+        m_isRowsSetValid = false;
         emit rangeChanged(this, ChangeReasonRange);
     }
 }
@@ -129,6 +184,13 @@ bool RangeGridRows::hasItemImpl(GridID id) const
     return m_rows.contains(id.row);
 }
 
+bool RangeGridRows::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows = m_rows;
+    columns = IntervalSet::all();
+    return true;
+}
+
 SharedPtr<RangeGridRows> makeRangeGridRows(const QSet<int>& rows)
 {
     return makeShared<RangeGridRows>(rows);
@@ -140,44 +202,79 @@ SharedPtr<RangeGridRows> makeRangeGridRows(int rowBegin, int rowEnd)
 }
 
 RangeGridRect::RangeGridRect(const QSet<int>& rows, const QSet<int>& columns)
-    : m_rows(rows),
-      m_columns(columns)
+    : m_rows(IntervalSet::fromSet(rows)),
+      m_columns(IntervalSet::fromSet(columns))
+{
+}
+
+RangeGridRect::RangeGridRect(IntervalSet rows, IntervalSet columns)
+    : m_rows(std::move(rows)),
+      m_columns(std::move(columns))
 {
 }
 
 RangeGridRect::RangeGridRect(int rowBegin, int rowEnd, int columnBegin, int columnEnd)
+    : m_rows(rowBegin, rowEnd),
+      m_columns(columnBegin, columnEnd)
 {
     Q_ASSERT(rowBegin <= rowEnd);
     Q_ASSERT(columnBegin <= columnEnd);
+}
 
-    for (; rowBegin < rowEnd; ++rowBegin)
-        m_rows.insert(rowBegin);
+const QSet<int>& RangeGridRect::rows() const
+{
+    if (!m_isRowsSetValid)
+    {
+        m_rowsSet = m_rows.toSet();
+        m_isRowsSetValid = true;
+    }
 
-    for (; columnBegin < columnEnd; ++columnBegin)
-        m_columns.insert(columnBegin);
+    return m_rowsSet;
 }
 
-void RangeGridRect::setRows(QSet<int> rows)
+void RangeGridRect::setRowIntervals(IntervalSet rows)
 {
     if (m_rows != rows)
     {
         m_rows = std::move(rows);
+        m_rowsSet.clear();
+        m_isRowsSetValid = false;
         emit rangeChanged(this, ChangeReasonRange);
     }
 }
 
-void RangeGridRect::setColumns(QSet<int> columns)
+const QSet<int>& RangeGridRect::columns() const
+{
+    if (!m_isColumnsSetValid)
+    {
+        m_columnsSet = m_columns.toSet();
+        m_isColumnsSetValid = true;
+    }
+
+    return m_columnsSet;
+}
+
+void RangeGridRect::setColumnIntervals(IntervalSet columns)
 {
     if (m_columns != columns)
     {
         m_columns = std::move(columns);
+        m_columnsSet.clear();
+        m_isColumnsSetValid = false;
         emit rangeChanged(this, ChangeReasonRange);
     }
 }
 
 bool RangeGridRect::hasItemImpl(GridID id) const
 {
-     return m_rows.contains(id.row) && m_columns.contains(id.column);
+    return m_rows.contains(id.row) && m_columns.contains(id.column);
+}
+
+bool RangeGridRect::gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const
+{
+    rows = m_rows;
+    columns = m_columns;
+    return true;
 }
 
 SharedPtr<RangeGridRect> makeRangeGridRect(const QSet<int>& rows, const QSet<int>& columns)
@@ -185,9 +282,19 @@ SharedPtr<RangeGridRect> makeRangeGridRect(const QSet<int>& rows, const QSet<int
     return makeShared<RangeGridRect>(rows, columns);
 }
 
+SharedPtr<RangeGridRect> makeRangeGridRect(IntervalSet rows, IntervalSet columns)
+{
+    return makeShared<RangeGridRect>(std::move(rows), std::move(columns));
+}
+
 SharedPtr<RangeGridRect> makeRangeGridRect(int rowBegin, int rowEnd, int columnBegin, int columnEnd)
 {
     return makeShared<RangeGridRect>(rowBegin, rowEnd, columnBegin, columnEnd);
 }
 
+SharedPtr<RangeGridRect> makeRangeGridRect(GridID id)
+{
+    return makeRangeGridRect(id.row, id.row + 1, id.column, id.column + 1);
+}
+
 } // end namespace Qi
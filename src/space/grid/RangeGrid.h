@@ -20,6 +20,7 @@
 #include "core/Range.h"
 #include "GridID.h"
 #include "Lines.h"
+#include "utils/IntervalSet.h"
 
 namespace Qi
 {
@@ -67,6 +68,7 @@ public:
 
 protected:
     bool hasItemImpl(GridID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
 
 private:
     int m_column;
@@ -78,17 +80,26 @@ class QI_EXPORT RangeGridColumns: public RangeGrid
     Q_OBJECT
 
 public:
-    explicit RangeGridColumns(QSet<int> columns);
+    explicit RangeGridColumns(const QSet<int>& columns);
+    explicit RangeGridColumns(IntervalSet columns);
     RangeGridColumns(int columnBegin, int columnEnd);
 
-    const QSet<int>& columns() const { return m_columns; }
-    void setColumns(QSet<int> columns);
+    // use columnIntervals, set is expanded on first call
+    Q_DECL_DEPRECATED const QSet<int>& columns() const;
+    void setColumns(const QSet<int>& columns) { setColumnIntervals(IntervalSet::fromSet(columns)); }
+
+    const IntervalSet& columnIntervals() const { return m_columns; }
+    void setColumnIntervals(IntervalSet columns);
 
 protected:
     bool hasItemImpl(GridID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
 
 private:
-    QSet<int> m_columns;
+    IntervalSet m_columns;
+    // expanded m_columns for deprecated getter
+    mutable QSet<int> m_columnsSet;
+    mutable bool m_isColumnsSetValid = false;
 };
 QI_EXPORT SharedPtr<RangeGridColumns> makeRangeGridColumns(const QSet<int>& columns);
 QI_EXPORT SharedPtr<RangeGridColumns> makeRangeGridColumns(int columnBegin, int columnEnd);
@@ -105,6 +116,7 @@ public:
 
 protected:
     bool hasItemImpl(GridID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
 
 private:
     int m_row;
@@ -116,16 +128,26 @@ class QI_EXPORT RangeGridRows: public RangeGrid
     Q_OBJECT
 
 public:
-    explicit RangeGridRows(QSet<int> rows);
+    explicit RangeGridRows(const QSet<int>& rows);
+    explicit RangeGridRows(IntervalSet rows);
     RangeGridRows(int rowBegin, int rowEnd);
 
-    const QSet<int>& rows() const { return m_rows; }
-    void setRows(QSet<int> rows);
+    // use rowIntervals, set is expanded on first call
+    Q_DECL_DEPRECATED const QSet<int>& rows() const;
+    void setRows(const QSet<int>& rows) { setRowIntervals(IntervalSet::fromSet(rows)); }
+
+    const IntervalSet& rowIntervals() const { return m_rows; }
+    void setRowIntervals(IntervalSet rows);
 
 protected:
     bool hasItemImpl(GridID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
+
 private:
-    QSet<int> m_rows;
+    IntervalSet m_rows;
+    // expanded m_rows for deprecated getter
+    mutable QSet<int> m_rowsSet;
+    mutable bool m_isRowsSetValid = false;
 };
 QI_EXPORT SharedPtr<RangeGridRows> makeRangeGridRows(const QSet<int>& rows);
 QI_EXPORT SharedPtr<RangeGridRows> makeRangeGridRows(int rowBegin, int rowEnd);
@@ -136,23 +158,40 @@ class QI_EXPORT RangeGridRect: public RangeGrid
 
 public:
     RangeGridRect(const QSet<int>& rows, const QSet<int>& columns);
+    RangeGridRect(IntervalSet rows, IntervalSet columns);
     RangeGridRect(int rowBegin, int rowEnd, int columnBegin, int columnEnd);
 
-    const QSet<int>& rows() const { return m_rows; }
-    void setRows(QSet<int> rows);
+    // use rowIntervals and columnIntervals, sets are expanded on first call
+    Q_DECL_DEPRECATED const QSet<int>& rows() const;
+    void setRows(const QSet<int>& rows) { setRowIntervals(IntervalSet::fromSet(rows)); }
+
+    Q_DECL_DEPRECATED const QSet<int>& columns() const;
+    void setColumns(const QSet<int>& columns) { setColumnIntervals(IntervalSet::fromSet(columns)); }
+
+    const IntervalSet& rowIntervals() const { return m_rows; }
+    void setRowIntervals(IntervalSet rows);
 
-    const QSet<int>& columns() const { return m_columns; }
-    void setColumns(QSet<int> columns);
+    const IntervalSet& columnIntervals() const { return m_columns; }
+    void setColumnIntervals(IntervalSet columns);
 
 protected:
     bool hasItemImpl(GridID id) const override;
+    bool gridStructureImpl(IntervalSet& rows, IntervalSet& columns) const override;
 
 private:
-    QSet<int> m_rows;
-    QSet<int> m_columns;
+    IntervalSet m_rows;
+    IntervalSet m_columns;
+    // expanded intervals for deprecated getters
+    mutable QSet<int> m_rowsSet;
+    mutable bool m_isRowsSetValid = false;
+    mutable QSet<int> m_columnsSet;
+    mutable bool m_isColumnsSetValid = false;
 };
 QI_EXPORT SharedPtr<RangeGridRect> makeRangeGridRect(const QSet<int>& rows, const QSet<int>& columns);
+QI_EXPORT SharedPtr<RangeGridRect> makeRangeGridRect(IntervalSet rows, IntervalSet columns);
 QI_EXPORT SharedPtr<RangeGridRect> makeRangeGridRect(int rowBegin, int rowEnd, int columnBegin, int columnEnd);
+// single cell range
+QI_EXPORT SharedPtr<RangeGridRect> makeRangeGridRect(GridID id);
 
 } // end namespace Qi 
 
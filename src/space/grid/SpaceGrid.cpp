@@ -18,6 +18,7 @@
 #include "RangeGrid.h"
 #include "core/Model.h"
 #include "cache/CacheItemFactory.h"
+#include <vector>
 
 namespace Qi
 {
@@ -33,19 +34,21 @@ SharedPtr<Range> makeRangeGridRect(const SpaceGrid& grid, GridID displayCorner1,
     GridID itemTopLeft(qMin(displayCorner1.row, displayCorner2.row), qMin(displayCorner1.column, displayCorner2.column));
     GridID itemBottomRight(qMax(displayCorner1.row, displayCorner2.row), qMax(displayCorner1.column, displayCorner2.column));
 
-    QSet<int> rows;
+    QVector<int> rows;
+    rows.reserve(itemBottomRight.row - itemTopLeft.row + 1);
     for (int row = itemTopLeft.row; row <= itemBottomRight.row; ++row)
     {
-        rows.insert(grid.rows()->toAbsolute(row));
+        rows.append(grid.rows()->toAbsolute(row));
     }
 
-    QSet<int> columns;
+    QVector<int> columns;
+    columns.reserve(itemBottomRight.column - itemTopLeft.column + 1);
     for (int column = itemTopLeft.column; column <= itemBottomRight.column; ++column)
     {
-        columns.insert(grid.columns()->toAbsolute(column));
+        columns.append(grid.columns()->toAbsolute(column));
     }
 
-    return makeRangeGridRect(rows, columns);
+    return makeRangeGridRect(IntervalSet::fromValues(std::move(rows)), IntervalSet::fromValues(std::move(columns)));
 }
 
 IdIteratorGridAll::IdIteratorGridAll(const SpaceGrid& spaceGrid)
@@ -159,92 +162,84 @@ bool ItemsIteratorGridByColumn::toNextImpl()
     return false;
 }
 
-class AscendingColumnComparatorByModel
+class AscendingComparatorByKeys
 {
 public:
-    AscendingColumnComparatorByModel(int column, const ModelComparable& model)
-        : m_leftItem(0, column),
-          m_rightItem(0, column),
-          m_model(model)
+    explicit AscendingComparatorByKeys(const SortKeys& keys)
+        : m_keys(keys)
     {}
 
-    bool operator() (int left, int right)
+    bool operator() (int left, int right) const
     {
-        m_leftItem.row = left;
-        m_rightItem.row = right;
-        return m_model.compareAs(m_leftItem, m_rightItem) < 0;
+        return m_keys.compare(left, right) < 0;
     }
 
 private:
-    GridID m_leftItem;
-    GridID m_rightItem;
-    const ModelComparable& m_model;
+    const SortKeys& m_keys;
 };
 
-class DescendingColumnComparatorByModel
+class DescendingComparatorByKeys
 {
 public:
-    DescendingColumnComparatorByModel(int column, const ModelComparable& model)
-        : m_leftItem(0, column),
-        m_rightItem(0, column),
-        m_model(model)
+    explicit DescendingComparatorByKeys(const SortKeys& keys)
+        : m_keys(keys)
     {}
 
-    bool operator() (int left, int right)
+    bool operator() (int left, int right) const
     {
-        m_leftItem.row = left;
-        m_rightItem.row = right;
-        return m_model.compareAs(m_leftItem, m_rightItem) > 0;
+        return m_keys.compare(left, right) > 0;
     }
 
 private:
-    GridID m_leftItem;
-    GridID m_rightItem;
-    const ModelComparable& m_model;
+    const SortKeys& m_keys;
 };
 
-class AscendingRowComparatorByModel
+class CompoundComparatorByKeys
 {
 public:
-    AscendingRowComparatorByModel(int row, const ModelComparable& model)
-        : m_leftItem(row, 0),
-        m_rightItem(row, 0),
-        m_model(model)
+    CompoundComparatorByKeys(const QVector<const SortKeys*>& keys, const QVector<bool>& ascending)
+        : m_keys(keys),
+          m_ascending(ascending)
     {}
 
-    bool operator() (int left, int right)
+    bool operator() (int left, int right) const
     {
-        m_leftItem.column = left;
-        m_rightItem.column = right;
-        return m_model.compareAs(m_leftItem, m_rightItem) < 0;
+        for (int i = 0; i < m_keys.size(); ++i)
+        {
+            int result = m_keys[i]->compare(left, right);
+            if (result != 0)
+                return m_ascending[i] ? result < 0 : result > 0;
+        }
+
+        return false;
     }
 
 private:
-    GridID m_leftItem;
-    GridID m_rightItem;
-    const ModelComparable& m_model;
+    const QVector<const SortKeys*>& m_keys;
+    const QVector<bool>& m_ascending;
 };
 
-class DescendingRowComparatorByModel
+class CompoundComparatorByModels
 {
 public:
-    DescendingRowComparatorByModel(int row, const ModelComparable& model)
-        : m_leftItem(row, 0),
-        m_rightItem(row, 0),
-        m_model(model)
+    explicit CompoundComparatorByModels(const QVector<SortingColumn>& columns)
+        : m_columns(columns)
     {}
 
-    bool operator() (int left, int right)
+    bool operator() (int left, int right) const
     {
-        m_leftItem.column = left;
-        m_rightItem.column = right;
-        return m_model.compareAs(m_leftItem, m_rightItem) > 0;
+        for (const auto& column : m_columns)
+        {
+            int result = column.model->compare(ID(GridID(left, column.column)), ID(GridID(right, column.column)));
+            if (result != 0)
+                return column.ascending ? result < 0 : result > 0;
+        }
+
+        return false;
     }
 
 private:
-    GridID m_leftItem;
-    GridID m_rightItem;
-    const ModelComparable& m_model;
+    const QVector<SortingColumn>& m_columns;
 };
 
 SpaceGrid::SpaceGrid(SpaceGridHint hint)
@@ -329,7 +324,7 @@ SharedPtr<CacheItemFactory> SpaceGrid::createCacheItemFactory() const
     case SpaceGridHintSameSchemasByRow:
         return createCacheItemFactorySameSchemaByRow(*this);
     default:
-        return createCacheItemFactoryDefault(*this);
+        return createCacheItemFactoryGrid(*this);
     }
 }
 
@@ -414,28 +409,84 @@ bool SpaceGrid::isItemVisible(GridID item) const
     return m_rows->isLineVisible(item.row) && m_columns->isLineVisible(item.column);
 }
 
-void SpaceGrid::sortColumnByModel(int column, const ModelComparable& model, bool ascending, bool stable)
+void SpaceGrid::sortColumnByModel(int column, const ModelComparable& model, bool ascending, bool stable, bool parallel)
 {
     // avoid invalid column
     if (column >= m_columns->count())
         return;
 
+    // extract keys once instead of querying model on every comparison
+    auto keys = model.sortKeys(m_rows->count(), [column](int row)->ID {
+        return ID(GridID(row, column));
+    });
+    parallel = parallel && keys->isReadThreadSafe();
+
     if (ascending)
-        m_rows->sort(stable, AscendingColumnComparatorByModel(column, model));
+        m_rows->sort(stable, AscendingComparatorByKeys(*keys), parallel);
     else
-        m_rows->sort(stable, DescendingColumnComparatorByModel(column, model));
+        m_rows->sort(stable, DescendingComparatorByKeys(*keys), parallel);
 }
 
-void SpaceGrid::sortRowByModel(int row, const ModelComparable &model, bool ascending, bool stable)
+void SpaceGrid::sortRowByModel(int row, const ModelComparable &model, bool ascending, bool stable, bool parallel)
 {
     // avoid invalid row
     if (row >= m_rows->count())
         return;
 
+    auto keys = model.sortKeys(m_columns->count(), [row](int column)->ID {
+        return ID(GridID(row, column));
+    });
+    parallel = parallel && keys->isReadThreadSafe();
+
     if (ascending)
-        m_columns->sort(stable, AscendingRowComparatorByModel(row, model));
+        m_columns->sort(stable, AscendingComparatorByKeys(*keys), parallel);
     else
-        m_columns->sort(stable, DescendingRowComparatorByModel(row, model));
+        m_columns->sort(stable, DescendingComparatorByKeys(*keys), parallel);
+}
+
+void SpaceGrid::sortColumnsByModels(const QVector<SortingColumn>& columns, bool stable, bool parallel)
+{
+    std::vector<UniquePtr<SortKeys>> keysHolder;
+    QVector<const SortKeys*> keys;
+    QVector<bool> ascending;
+
+    for (const auto& column : columns)
+    {
+        // avoid invalid column
+        if (column.column >= m_columns->count() || !column.model)
+            continue;
+
+        int columnIndex = column.column;
+        keysHolder.push_back(column.model->sortKeys(m_rows->count(), [columnIndex](int row)->ID {
+            return ID(GridID(row, columnIndex));
+        }));
+
+        keys.append(keysHolder.back().get());
+        ascending.append(column.ascending);
+        parallel = parallel && keys.last()->isReadThreadSafe();
+    }
+
+    if (keys.isEmpty())
+        return;
+
+    m_rows->sort(stable, CompoundComparatorByKeys(keys, ascending), parallel);
+}
+
+void SpaceGrid::resortRowsByModels(const QVector<int>& rows, const QVector<SortingColumn>& columns)
+{
+    QVector<SortingColumn> validColumns;
+    for (const auto& column : columns)
+    {
+        // avoid invalid column
+        if (column.column < m_columns->count() && column.model)
+            validColumns.append(column);
+    }
+
+    if (validColumns.isEmpty())
+        return;
+
+    // few rows are compared directly by models
+    m_rows->resort(rows, CompoundComparatorByModels(validColumns));
 }
 
 void SpaceGrid::onLinesChanged(const Lines* /*lines*/, ChangeReason reason)
@@ -28,6 +28,13 @@ namespace Qi
 
 class ModelComparable;
 
+struct SortingColumn
+{
+    int column;
+    const ModelComparable* model;
+    bool ascending;
+};
+
 enum SpaceGridHint
 {
     SpaceGridHintNone = 0x0000,
@@ -86,8 +93,13 @@ public:
     bool checkVisibleItem(GridID id) const;
     bool isItemVisible(GridID id) const;
 
-    void sortColumnByModel(int column, const ModelComparable &model, bool ascending, bool stable);
-    void sortRowByModel(int row, const ModelComparable& model, bool ascending, bool stable);
+    // parallel sorting is stable and used if model keys are thread safe
+    void sortColumnByModel(int column, const ModelComparable &model, bool ascending, bool stable, bool parallel = false);
+    void sortRowByModel(int row, const ModelComparable& model, bool ascending, bool stable, bool parallel = false);
+    // sorts rows by first column, rows with equal keys by next column and so on
+    void sortColumnsByModels(const QVector<SortingColumn>& columns, bool stable, bool parallel = false);
+    // moves rows to keep rows sorted by columns
+    void resortRowsByModels(const QVector<int>& rows, const QVector<SortingColumn>& columns);
 
 private slots:
     void onLinesChanged(const Lines* lines, ChangeReason reason);
@@ -0,0 +1,101 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "FenwickTree.h"
+
+namespace Qi
+{
+
+void FenwickTree::clear()
+{
+    m_values.clear();
+    m_tree.clear();
+    m_highBit = 0;
+    m_totalSum = 0;
+}
+
+void FenwickTree::assign(const QVector<int>& values)
+{
+    m_values = values;
+
+    int count = m_values.size();
+    m_tree.resize(count + 1);
+    m_tree[0] = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        Q_ASSERT(m_values[i] >= 0);
+        m_tree[i + 1] = m_values[i];
+    }
+
+    // propagate every node into its parent
+    for (int i = 1; i <= count; ++i)
+    {
+        int parent = i + (i & -i);
+        if (parent <= count)
+            m_tree[parent] += m_tree[i];
+    }
+
+    m_highBit = 1;
+    while ((m_highBit << 1) <= count)
+        m_highBit <<= 1;
+
+    m_totalSum = prefixSum(count);
+}
+
+void FenwickTree::setValue(int index, int value)
+{
+    Q_ASSERT(index >= 0 && index < m_values.size());
+    Q_ASSERT(value >= 0);
+
+    int delta = value - m_values[index];
+    if (delta == 0)
+        return;
+
+    m_values[index] = value;
+    m_totalSum += delta;
+
+    for (int i = index + 1, count = m_values.size(); i <= count; i += (i & -i))
+        m_tree[i] += delta;
+}
+
+int FenwickTree::prefixSum(int count) const
+{
+    Q_ASSERT(count >= 0 && count <= m_values.size());
+
+    int sum = 0;
+    for (int i = count; i > 0; i -= (i & -i))
+        sum += m_tree[i];
+
+    return sum;
+}
+
+int FenwickTree::findPrefix(int sum) const
+{
+    int count = 0;
+    for (int step = m_highBit, size = m_values.size(); step > 0; step >>= 1)
+    {
+        int next = count + step;
+        if (next <= size && m_tree[next] <= sum)
+        {
+            count = next;
+            sum -= m_tree[next];
+        }
+    }
+
+    return count;
+}
+
+} // end namespace Qi
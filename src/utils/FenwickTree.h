@@ -0,0 +1,60 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_FENWICK_TREE_H
+#define QI_FENWICK_TREE_H
+
+#include "QiAPI.h"
+#include <QVector>
+
+namespace Qi
+{
+
+// binary indexed tree over non-negative values
+// supports O(log n) value updates, prefix sums and prefix searches
+class QI_EXPORT FenwickTree
+{
+public:
+    FenwickTree() = default;
+
+    int size() const { return m_values.size(); }
+    bool isEmpty() const { return m_values.isEmpty(); }
+
+    void clear();
+    // rebuilds tree in O(n)
+    void assign(const QVector<int>& values);
+
+    int value(int index) const { Q_ASSERT(index >= 0 && index < m_values.size()); return m_values[index]; }
+    void setValue(int index, int value);
+
+    // returns sum of values in range [0, count)
+    int prefixSum(int count) const;
+    int totalSum() const { return m_totalSum; }
+
+    // returns the greatest count so prefixSum(count) <= sum
+    int findPrefix(int sum) const;
+
+private:
+    QVector<int> m_values;
+    // m_tree[i] - sum of values in range [i - lowbit(i), i), m_tree[0] is unused
+    QVector<int> m_tree;
+    int m_highBit = 0;
+    int m_totalSum = 0;
+};
+
+} // end namespace Qi
+
+#endif // QI_FENWICK_TREE_H
@@ -0,0 +1,238 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "IntervalSet.h"
+#include <algorithm>
+
+namespace Qi
+{
+
+IntervalSet::IntervalSet(int begin, int end)
+{
+    if (begin < end)
+    {
+        Interval interval = { begin, end };
+        m_intervals.append(interval);
+    }
+}
+
+IntervalSet IntervalSet::fromValues(QVector<int> values)
+{
+    std::sort(values.begin(), values.end());
+
+    IntervalSet result;
+    for (int value : values)
+    {
+        if (!result.m_intervals.isEmpty() && result.m_intervals.last().end >= value)
+        {
+            // extend last interval
+            result.m_intervals.last().end = qMax(result.m_intervals.last().end, value + 1);
+        }
+        else
+        {
+            Interval interval = { value, value + 1 };
+            result.m_intervals.append(interval);
+        }
+    }
+
+    return result;
+}
+
+IntervalSet IntervalSet::fromSet(const QSet<int>& values)
+{
+    QVector<int> valuesVector;
+    valuesVector.reserve(values.size());
+    for (int value : values)
+        valuesVector.append(value);
+
+    return fromValues(std::move(valuesVector));
+}
+
+qint64 IntervalSet::count() const
+{
+    qint64 result = 0;
+    for (const auto& interval : m_intervals)
+        result += (qint64)interval.end - interval.begin;
+
+    return result;
+}
+
+bool IntervalSet::contains(int value) const
+{
+    // first interval which begins after the value
+    auto it = std::upper_bound(m_intervals.begin(), m_intervals.end(), value, [](int value, const Interval& interval) {
+        return value < interval.begin;
+    });
+
+    if (it == m_intervals.begin())
+        return false;
+
+    --it;
+    return value < it->end;
+}
+
+void IntervalSet::insert(int begin, int end)
+{
+    if (begin >= end)
+        return;
+
+    // intervals touching [begin, end) are merged
+    int first = std::lower_bound(m_intervals.cbegin(), m_intervals.cend(), begin, [](const Interval& interval, int value) {
+        return interval.end < value;
+    }) - m_intervals.cbegin();
+    int last = std::upper_bound(m_intervals.cbegin() + first, m_intervals.cend(), end, [](int value, const Interval& interval) {
+        return value < interval.begin;
+    }) - m_intervals.cbegin();
+
+    if (first < last)
+    {
+        begin = qMin(begin, m_intervals[first].begin);
+        end = qMax(end, m_intervals[last - 1].end);
+        m_intervals.remove(first, last - first);
+    }
+
+    Interval interval = { begin, end };
+    m_intervals.insert(first, interval);
+}
+
+void IntervalSet::remove(int begin, int end)
+{
+    if (begin >= end)
+        return;
+
+    // intervals overlapping [begin, end)
+    int first = std::upper_bound(m_intervals.cbegin(), m_intervals.cend(), begin, [](int value, const Interval& interval) {
+        return value < interval.end;
+    }) - m_intervals.cbegin();
+    int last = std::lower_bound(m_intervals.cbegin() + first, m_intervals.cend(), end, [](const Interval& interval, int value) {
+        return interval.begin < value;
+    }) - m_intervals.cbegin();
+
+    if (first >= last)
+        return;
+
+    Interval left = { m_intervals[first].begin, begin };
+    Interval right = { end, m_intervals[last - 1].end };
+
+    m_intervals.remove(first, last - first);
+
+    if (right.begin < right.end)
+        m_intervals.insert(first, right);
+    if (left.begin < left.end)
+        m_intervals.insert(first, left);
+}
+
+void IntervalSet::unite(const IntervalSet& other)
+{
+    if (other.isEmpty())
+        return;
+
+    if (isEmpty())
+    {
+        m_intervals = other.m_intervals;
+        return;
+    }
+
+    QVector<Interval> result;
+    result.reserve(m_intervals.size() + other.m_intervals.size());
+
+    auto append = [&result](const Interval& interval) {
+        if (!result.isEmpty() && result.last().end >= interval.begin)
+            result.last().end = qMax(result.last().end, interval.end);
+        else
+            result.append(interval);
+    };
+
+    // merge sorted intervals
+    int i = 0, j = 0;
+    while (i < m_intervals.size() || j < other.m_intervals.size())
+    {
+        if (j == other.m_intervals.size() || (i < m_intervals.size() && m_intervals[i].begin < other.m_intervals[j].begin))
+            append(m_intervals[i++]);
+        else
+            append(other.m_intervals[j++]);
+    }
+
+    m_intervals.swap(result);
+}
+
+void IntervalSet::subtract(const IntervalSet& other)
+{
+    if (isEmpty() || other.isEmpty())
+        return;
+
+    QVector<Interval> result;
+    result.reserve(m_intervals.size() + other.m_intervals.size());
+
+    int j = 0;
+    for (Interval interval : m_intervals)
+    {
+        // skip intervals which end before current one
+        while (j < other.m_intervals.size() && other.m_intervals[j].end <= interval.begin)
+            ++j;
+
+        // cut current interval by overlapping intervals
+        for (int k = j; k < other.m_intervals.size() && other.m_intervals[k].begin < interval.end; ++k)
+        {
+            if (other.m_intervals[k].begin > interval.begin)
+            {
+                Interval piece = { interval.begin, other.m_intervals[k].begin };
+                result.append(piece);
+            }
+            interval.begin = qMax(interval.begin, other.m_intervals[k].end);
+        }
+
+        if (interval.begin < interval.end)
+            result.append(interval);
+    }
+
+    m_intervals.swap(result);
+}
+
+IntervalSet IntervalSet::intersected(const IntervalSet& other) const
+{
+    IntervalSet result;
+
+    int i = 0, j = 0;
+    while (i < m_intervals.size() && j < other.m_intervals.size())
+    {
+        Interval interval = { qMax(m_intervals[i].begin, other.m_intervals[j].begin), qMin(m_intervals[i].end, other.m_intervals[j].end) };
+        if (interval.begin < interval.end)
+            result.m_intervals.append(interval);
+
+        // advance interval which ends first
+        if (m_intervals[i].end < other.m_intervals[j].end)
+            ++i;
+        else
+            ++j;
+    }
+
+    return result;
+}
+
+QSet<int> IntervalSet::toSet() const
+{
+    QSet<int> result;
+    for (const auto& interval : m_intervals)
+    {
+        for (int value = interval.begin; value < interval.end; ++value)
+            result.insert(value);
+    }
+
+    return result;
+}
+
+} // end namespace Qi
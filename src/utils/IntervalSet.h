@@ -0,0 +1,77 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_INTERVAL_SET_H
+#define QI_INTERVAL_SET_H
+
+#include "QiAPI.h"
+#include <QVector>
+#include <QSet>
+#include <limits>
+
+namespace Qi
+{
+
+// set of integers stored as sorted disjoint intervals
+// membership test is O(log n) where n is number of intervals
+class QI_EXPORT IntervalSet
+{
+public:
+    // half-open interval [begin, end)
+    struct Interval
+    {
+        int begin;
+        int end;
+
+        bool operator==(const Interval& other) const { return begin == other.begin && end == other.end; }
+        bool operator!=(const Interval& other) const { return !(*this == other); }
+    };
+
+    IntervalSet() = default;
+    IntervalSet(int begin, int end);
+
+    static IntervalSet all() { return IntervalSet(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()); }
+    static IntervalSet fromValues(QVector<int> values);
+    static IntervalSet fromSet(const QSet<int>& values);
+
+    bool isEmpty() const { return m_intervals.isEmpty(); }
+    void clear() { m_intervals.clear(); }
+
+    const QVector<Interval>& intervals() const { return m_intervals; }
+    // number of values in the set
+    qint64 count() const;
+
+    bool contains(int value) const;
+
+    void insert(int begin, int end);
+    void remove(int begin, int end);
+
+    void unite(const IntervalSet& other);
+    void subtract(const IntervalSet& other);
+    IntervalSet intersected(const IntervalSet& other) const;
+
+    QSet<int> toSet() const;
+
+    bool operator==(const IntervalSet& other) const { return m_intervals == other.m_intervals; }
+    bool operator!=(const IntervalSet& other) const { return m_intervals != other.m_intervals; }
+
+private:
+    QVector<Interval> m_intervals;
+};
+
+} // end namespace Qi
+
+#endif // QI_INTERVAL_SET_H
@@ -0,0 +1,88 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#include "ParallelSort.h"
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <algorithm>
+
+namespace Qi
+{
+
+static const int ParallelSortMin = 32 * 1024;
+
+void parallelStableSort(QVector<int>& values, const std::function<bool(int, int)>& lessThan)
+{
+    int count = values.size();
+    int threadsCount = QThread::idealThreadCount();
+
+    if (count < ParallelSortMin || threadsCount < 2)
+    {
+        std::stable_sort(values.begin(), values.end(), lessThan);
+        return;
+    }
+
+    struct Run
+    {
+        int begin;
+        int middle;
+        int end;
+    };
+
+    // sort one run per thread
+    int runSize = (count + threadsCount - 1) / threadsCount;
+    QVector<Run> runs;
+    for (int begin = 0; begin < count; begin += runSize)
+    {
+        Run run = { begin, begin, qMin(begin + runSize, count) };
+        runs.append(run);
+    }
+
+    int* source = values.data();
+    QtConcurrent::blockingMap(runs, [source, &lessThan](const Run& run) {
+        std::stable_sort(source + run.begin, source + run.end, lessThan);
+    });
+
+    QVector<int> buffer(count);
+    int* target = buffer.data();
+
+    // merge adjacent runs pairwise, left run goes first to keep sorting stable
+    while (runs.size() > 1)
+    {
+        QVector<Run> merges;
+        for (int i = 0; i < runs.size(); i += 2)
+        {
+            Run merge = { runs[i].begin, runs[i].end, runs[i].end };
+            if (i + 1 < runs.size())
+                merge.end = runs[i + 1].end;
+            merges.append(merge);
+        }
+
+        QtConcurrent::blockingMap(merges, [source, target, &lessThan](const Run& merge) {
+            std::merge(source + merge.begin, source + merge.middle,
+                       source + merge.middle, source + merge.end,
+                       target + merge.begin, lessThan);
+        });
+
+        std::swap(source, target);
+        runs = merges;
+    }
+
+    if (source != values.data())
+        std::copy(source, source + count, values.data());
+}
+
+} // end namespace Qi
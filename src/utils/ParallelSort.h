@@ -0,0 +1,34 @@
+/*
+   Copyright (c) 2008-1015 Alex Zhondin <qtinuum.team@gmail.com>
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef QI_PARALLEL_SORT_H
+#define QI_PARALLEL_SORT_H
+
+#include "QiAPI.h"
+#include <QVector>
+#include <functional>
+
+namespace Qi
+{
+
+// stable merge sort using several threads
+// result is identical to std::stable_sort with the same lessThan
+// lessThan is called simultaneously from several threads
+QI_EXPORT void parallelStableSort(QVector<int>& values, const std::function<bool(int, int)>& lessThan);
+
+} // end namespace Qi
+
+#endif // QI_PARALLEL_SORT_H
@@ -150,10 +150,10 @@ void GridWidget::onSubGridChanged(const Space* /*space*/, ChangeReason reason)
     }
 }
 
-void GridWidget::onCacheSpaceChanged(const CacheSpace* /*cache*/, ChangeReason /*reason*/)
+void GridWidget::onCacheSpaceChanged(const CacheSpace* /*cache*/, ChangeReason reason, const QRegion& dirtyRegion)
 {
-    // repaint widget
-    viewport()->update();
+    // repaint widget (sub-grid windows are in viewport coordinates)
+    updateOwner(reason, dirtyRegion);
 }
 
 QSize GridWidget::calculateVirtualSizeImpl() const
@@ -192,6 +192,33 @@ void GridWidget::updateCacheScrollOffsetImpl()
     cacheSubGrid(clientID)->setScrollOffset(scrollPos);
 }
 
+void GridWidget::scrollViewportImpl(int dx, int dy)
+{
+    // fully scrollable sub-grid - client
+    scrollSubGrid(clientID, dx, dy);
+
+    // horizontally scrollable sub-grids (top and bottom)
+    if (dx != 0)
+    {
+        scrollSubGrid(topID, dx, 0);
+        scrollSubGrid(bottomID, dx, 0);
+    }
+
+    // vertically scrollable sub-grids (left and right)
+    if (dy != 0)
+    {
+        scrollSubGrid(leftID, 0, dy);
+        scrollSubGrid(rightID, 0, dy);
+    }
+}
+
+void GridWidget::scrollSubGrid(GridID subGridID, int dx, int dy)
+{
+    QRect window = cacheSubGrid(subGridID)->window();
+    if (!window.isEmpty())
+        viewport()->scroll(dx, dy, window);
+}
+
 void GridWidget::validateCacheItemsLayoutImpl()
 {
     QSize visibleSize = viewport()->size();
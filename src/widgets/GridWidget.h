@@ -72,10 +72,12 @@ protected:
     QSize calculateVirtualSizeImpl() const override;
     QSize calculateScrollableSizeImpl() const override;
     void updateCacheScrollOffsetImpl() override;
+    void scrollViewportImpl(int dx, int dy) override;
 
 private:
     void onSubGridChanged(const Space* space, ChangeReason reason);
-    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason);
+    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion);
+    void scrollSubGrid(GridID subGridID, int dx, int dy);
 
     SharedPtr<SpaceGrid> m_mainGrid;
 
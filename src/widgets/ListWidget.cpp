@@ -51,11 +51,11 @@ ListWidget::~ListWidget()
 {
 }
 
-void ListWidget::onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason /*reason*/)
+void ListWidget::onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion)
 {
     Q_UNUSED(cache);
     Q_ASSERT(cache == m_cacheGrid.data());
-    viewport()->update();;
+    updateOwner(reason, dirtyRegion);
 }
 
 void ListWidget::onSpaceGridChanged(const Space* space, ChangeReason reason)
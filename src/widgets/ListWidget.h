@@ -51,7 +51,7 @@ protected:
     QPixmap createPixmapImpl() const;
 
 private:
-    void onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason reason);
+    void onCacheSpaceGridChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion);
     void onSpaceGridChanged(const Space* space, ChangeReason reason);
 
     SharedPtr<SpaceGrid> m_grid;
@@ -28,7 +28,8 @@ namespace Qi
 
 SpaceWidgetCore::SpaceWidgetCore(QWidget* owner)
     : m_owner(owner),
-      m_guiContext(owner)
+      m_guiContext(owner),
+      m_isScrollingContent(false)
 {
     Q_ASSERT(m_owner);
 
@@ -70,8 +71,8 @@ bool SpaceWidgetCore::initSpaceWidgetCore(SharedPtr<CacheSpace> mainCacheSpace)
     m_mainCacheSpace = std::move(mainCacheSpace);
     m_cacheControllers = makeUnique<CacheControllerMouse>(m_owner, this, m_mainCacheSpace);
 
-    m_connection = QObject::connect(m_mainCacheSpace.data(), &CacheSpace::cacheChanged, [this](const CacheSpace* cache, ChangeReason reason) {
-        onCacheSpaceChanged(cache, reason);
+    m_connection = QObject::connect(m_mainCacheSpace.data(), &CacheSpace::cacheChanged, [this](const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion) {
+        onCacheSpaceChanged(cache, reason, dirtyRegion);
     });
 
     // enable tracking mouse moves
@@ -125,6 +126,8 @@ bool SpaceWidgetCore::processOwnerEvent(QEvent* event)
         QPainter painter(m_owner);
         painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::HighQualityAntialiasing);
         painter.setBackgroundMode(Qt::TransparentMode);
+        // let caches skip items out of the repainted area
+        painter.setClipRegion(static_cast<QPaintEvent*>(event)->region());
         // draw cache
         m_mainCacheSpace->draw(&painter, GuiContext(m_owner));
     } break;
@@ -201,12 +204,24 @@ void SpaceWidgetCore::resumeControllers()
         m_cacheControllers->resume();
 }
 
-void SpaceWidgetCore::onCacheSpaceChanged(const CacheSpace* cache, ChangeReason /*reason*/)
+void SpaceWidgetCore::updateOwner(ChangeReason reason, const QRegion& dirtyRegion)
+{
+    // scrolled pixels are already moved by the owner
+    if (m_isScrollingContent && !(reason & ~(ChangeReasonCacheItems | ChangeReasonCacheFrame)))
+        return;
+
+    if (dirtyRegion.isEmpty())
+        m_owner->update();
+    else
+        m_owner->update(dirtyRegion);
+}
+
+void SpaceWidgetCore::onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion)
 {
     Q_UNUSED(cache);
     Q_ASSERT(m_mainCacheSpace.data() == cache);
     // repaint owner widget
-    m_owner->update();
+    updateOwner(reason, dirtyRegion);
 }
 
 QPixmap SpaceWidgetCore::createPixmapImpl() const
@@ -69,13 +69,19 @@ protected:
     void stopControllers();
     void resumeControllers();
 
+    // while content is scrolled by blitting, frame changes of caches don't repaint owner
+    void setScrollingContent(bool isScrollingContent) { m_isScrollingContent = isScrollingContent; }
+    // repaints owner widget if cache change requires it
+    // empty dirtyRegion repaints whole owner
+    void updateOwner(ChangeReason reason, const QRegion& dirtyRegion = QRegion());
+
     // scrolls widget to make visibleItem fully visible
     virtual void ensureVisibleImpl(const ID& visibleItem, const CacheSpace *cacheSpace, bool validateItem) = 0;
     // creates image of the widget
     virtual QPixmap createPixmapImpl() const;
 
 private:
-    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason);
+    void onCacheSpaceChanged(const CacheSpace* cache, ChangeReason reason, const QRegion& dirtyRegion);
 
     QWidget* m_owner;
 
@@ -84,6 +90,7 @@ private:
     SharedPtr<ControllerKeyboard> m_controllerKeyboard;
 
     GuiContext m_guiContext;
+    bool m_isScrollingContent;
 
     QMetaObject::Connection m_connection;
 
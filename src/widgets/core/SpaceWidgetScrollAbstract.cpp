@@ -165,8 +165,19 @@ void SpaceWidgetScrollAbstract::focusOutEvent(QFocusEvent * event)
 
 void SpaceWidgetScrollAbstract::scrollContentsBy(int dx, int dy)
 {
-    QAbstractScrollArea::scrollContentsBy(dx, dy);
+    // QAbstractScrollArea::scrollContentsBy repaints whole viewport
+    if (!m_isCacheItemsLayoutValid)
+    {
+        updateCacheScrollOffsetImpl();
+        viewport()->update();
+        return;
+    }
+
+    setScrollingContent(true);
     updateCacheScrollOffsetImpl();
+    setScrollingContent(false);
+
+    scrollViewportImpl(dx, dy);
 }
 
 QSize SpaceWidgetScrollAbstract::viewportSizeHint() const
@@ -231,6 +242,17 @@ void SpaceWidgetScrollAbstract::updateCacheScrollOffsetImpl()
     m_scrollableCacheSpace->setScrollOffset(scrollPos);
 }
 
+void SpaceWidgetScrollAbstract::scrollViewportImpl(int dx, int dy)
+{
+    Q_ASSERT(!m_scrollableCacheSpace.isNull());
+    if (m_scrollableCacheSpace.isNull())
+        return;
+
+    QRect window = m_scrollableCacheSpace->window();
+    if (!window.isEmpty())
+        viewport()->scroll(dx, dy, window);
+}
+
 void SpaceWidgetScrollAbstract::validateCacheItemsLayoutImpl()
 {
     rMainCacheSpace().setWindow(viewport()->rect());
@@ -55,6 +55,8 @@ protected:
     virtual QSize calculateVirtualSizeImpl() const;
     virtual QSize calculateScrollableSizeImpl() const;
     virtual void updateCacheScrollOffsetImpl();
+    // moves already drawn viewport pixels, only exposed parts will be repainted
+    virtual void scrollViewportImpl(int dx, int dy);
 
 private:
     // hide method
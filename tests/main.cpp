@@ -4,10 +4,12 @@
 #include "test_grid.h"
 
 #include <QtTest/QtTest>
+#include <QApplication>
 
 int main(int argc, char* argv[])
 {
-    QCoreApplication app(argc, argv);
+    // widgets are needed to measure views
+    QApplication app(argc, argv);
 
     int result = 0;
 
@@ -1,8 +1,21 @@
 #include "test_grid.h"
 #include "test_item_id.h"
 #include "space/grid/SpaceGrid.h"
+#include "space/grid/CacheSpaceGrid.h"
+#include "space/grid/RangeGrid.h"
+#include "cache/CacheItemFactory.h"
+#include "cache/CacheItem.h"
+#include "core/ext/Ranges.h"
+#include "core/ext/Views.h"
+#include "core/ext/ViewComposite.h"
+#include "misc/GridColumnsResizer.h"
+#include "core/ext/ModelCallback.h"
+#include "core/ext/ModelStore.h"
+#include "items/selection/SelectionIterators.h"
 #include "SignalSpy.h"
 #include <QtTest/QtTest>
+#include <QWidget>
+#include <algorithm>
 
 using namespace Qi;
 
@@ -142,3 +155,366 @@ void TestGrid::test()
     QCOMPARE(signalSpy.size(), 26);
     */
 }
+
+void TestGrid::testSortColumnByModel()
+{
+    SpaceGrid grid;
+    grid.rows()->setCount(6);
+    grid.columns()->setCount(2);
+
+    QVector<QString> values;
+    values << "d" << "b" << "e" << "b" << "a" << "c";
+
+    ModelCallback<QString> model([&values](ID id)->QString {
+        return values[id.as<GridID>().row];
+    });
+
+    auto signalSpy = createSignalSpy(grid.rows().data(), &Lines::linesChanged);
+
+    grid.sortColumnByModel(1, model, true, true);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(signalSpy.getLast<1>(), ChangeReasonLinesOrder);
+    QCOMPARE(grid.rows()->permutation(), QVector<int>() << 4 << 1 << 3 << 5 << 0 << 2);
+
+    grid.sortColumnByModel(1, model, false, true);
+    QCOMPARE(grid.rows()->permutation(), QVector<int>() << 2 << 0 << 5 << 1 << 3 << 4);
+
+    // invalid column is ignored
+    grid.sortColumnByModel(2, model, true, true);
+    QCOMPARE(signalSpy.size(), 2);
+}
+
+void TestGrid::testSortColumnsByModels()
+{
+    SpaceGrid grid;
+    grid.rows()->setCount(6);
+    grid.columns()->setCount(2);
+
+    QVector<QString> desks;
+    desks << "b" << "a" << "b" << "a" << "c" << "a";
+    QVector<int> pnls;
+    pnls << 5 << 3 << 7 << 3 << 1 << 9;
+
+    ModelCallback<QString> deskModel([&desks](ID id)->QString {
+        return desks[id.as<GridID>().row];
+    });
+    ModelCallback<int> pnlModel([&pnls](ID id)->int {
+        return pnls[id.as<GridID>().row];
+    });
+
+    QVector<SortingColumn> columns;
+    SortingColumn deskColumn = { 0, &deskModel, true };
+    SortingColumn pnlColumn = { 1, &pnlModel, false };
+    columns << deskColumn << pnlColumn;
+
+    auto signalSpy = createSignalSpy(grid.rows().data(), &Lines::linesChanged);
+
+    grid.sortColumnsByModels(columns, true);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(grid.rows()->permutation(), QVector<int>() << 5 << 1 << 3 << 2 << 0 << 4);
+}
+
+// views of the schema, composite views are created by each factory separately
+static QVector<const View*> schemaViews(const ViewSchema& schema, ID id)
+{
+    QVector<const View*> views;
+    if (schema.view)
+        schema.view->addView(id, views);
+
+    views.erase(std::remove_if(views.begin(), views.end(), [](const View* view) {
+        return qobject_cast<const ViewComposite*>(view) != nullptr;
+    }), views.end());
+
+    return views;
+}
+
+void TestGrid::testCacheItemFactoryGrid()
+{
+    auto grid = makeShared<SpaceGrid>();
+    grid->setDimensions(30, 10);
+    grid->addSchema(makeRangeGridColumn(2), makeShared<ViewCallback>());
+    grid->addSchema(makeRangeGridRows(5, 15), makeShared<ViewCallback>());
+    grid->addSchema(makeRangeGridRect(3, 8, 1, 4), makeShared<ViewCallback>());
+    // range without grid structure
+    grid->addSchema(makeShared<RangeCallback>([](ID id)->bool {
+        return id.as<GridID>().row % 7 == 0;
+    }), makeShared<ViewCallback>());
+    grid->addSchema(makeRangeGridRow(29), makeShared<ViewCallback>());
+
+    auto factoryDefault = createCacheItemFactoryDefault(*grid);
+    auto factoryGrid = createCacheItemFactoryGrid(*grid);
+
+    for (GridID id(0, 0); id.row < grid->rowsCount(); ++id.row)
+    {
+        for (id.column = 0; id.column < grid->columnsCount(); ++id.column)
+        {
+            CacheItemInfo infoDefault = factoryDefault->create(ID(id));
+            CacheItemInfo infoGrid = factoryGrid->create(ID(id));
+
+            QCOMPARE(infoGrid.id, infoDefault.id);
+            QCOMPARE(infoGrid.rect, infoDefault.rect);
+            QCOMPARE(infoGrid.schema.isValid(), infoDefault.schema.isValid());
+            QCOMPARE(schemaViews(infoGrid.schema, infoGrid.id), schemaViews(infoDefault.schema, infoDefault.id));
+        }
+    }
+}
+
+// checks every cache item in the window against the grid
+static bool isCacheItemsValid(const CacheSpaceGrid& cache)
+{
+    GridID idStart, idEnd;
+    cache.visibleItemsRange(idStart, idEnd);
+
+    for (GridID id = idStart; id.row <= idEnd.row; ++id.row)
+    {
+        for (id.column = idStart.column; id.column <= idEnd.column; ++id.column)
+        {
+            const CacheItem* cacheItem = cache.cacheItem(ID(id));
+            if (!cacheItem || cacheItem->id != ID(id))
+                return false;
+
+            if (cacheItem->rect != cache.spaceGrid()->itemRect(ID(id)).translated(cache.originPos()))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void TestGrid::testCacheSpaceScroll()
+{
+    auto grid = makeShared<SpaceGrid>();
+    grid->setDimensions(100, 50);
+    grid->rows()->setLineSizeAll(20);
+    grid->columns()->setLineSizeAll(40);
+    grid->addSchema(makeRangeAll(), makeShared<ViewCallback>());
+
+    // window holds 6x6 items
+    CacheSpaceGrid cache(grid);
+    cache.setWindow(QRect(0, 0, 200, 100));
+
+    GridID idStart, idEnd;
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idStart, GridID(0, 0));
+    QCOMPARE(idEnd, GridID(5, 5));
+    QVERIFY(isCacheItemsValid(cache));
+
+    // scroll within items
+    cache.setScrollOffset(QPoint(10, 5));
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idStart, GridID(0, 0));
+    QVERIFY(isCacheItemsValid(cache));
+
+    // scroll less than a window
+    cache.setScrollOffset(QPoint(80, 40));
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idStart, GridID(2, 2));
+    QCOMPARE(idEnd, GridID(7, 7));
+    QVERIFY(isCacheItemsValid(cache));
+
+    // scroll rows by exactly a window
+    cache.setScrollOffset(QPoint(80, 160));
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idStart, GridID(8, 2));
+    QVERIFY(isCacheItemsValid(cache));
+
+    // scroll back less than a window
+    cache.setScrollOffset(QPoint(40, 100));
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idStart, GridID(5, 1));
+    QVERIFY(isCacheItemsValid(cache));
+
+    // scroll more than a window
+    cache.setScrollOffset(QPoint(1000, 600));
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idStart, GridID(30, 25));
+    QCOMPARE(idEnd, GridID(35, 30));
+    QVERIFY(isCacheItemsValid(cache));
+
+    // window size change relayouts items
+    cache.setWindow(QRect(0, 0, 120, 60));
+    cache.visibleItemsRange(idStart, idEnd);
+    QCOMPARE(idEnd, GridID(33, 28));
+    QVERIFY(isCacheItemsValid(cache));
+}
+
+void TestGrid::testColumnFitWidthSampler()
+{
+    QWidget widget;
+    GuiContext ctx(&widget);
+
+    auto grid = makeShared<SpaceGrid>();
+    grid->setDimensions(800, 2);
+
+    // the widest row is not among evenly spread samples
+    auto view = makeShared<ViewCallback>();
+    view->sizeFunction = [](const GuiContext&, ID id, ViewSizeMode)->QSize {
+        int row = id.as<GridID>().row;
+        return QSize((row == 777) ? 500 : 10 + row % 50, 20);
+    };
+    grid->addSchema(makeRangeGridColumn(1), view);
+
+    int fitWidth = calculateColumnFitWidth(*grid, 1, ctx);
+
+    ColumnFitWidthSampler sampler(1, ctx);
+    sampler.addGrid(grid);
+    QVERIFY(sampler.estimate(100) < fitWidth);
+    QVERIFY(!sampler.isExact());
+
+    int refineCount = 0;
+    while (!sampler.refine(0))
+        ++refineCount;
+
+    QVERIFY(refineCount > 0);
+    QVERIFY(sampler.isExact());
+    QCOMPARE(sampler.fitWidth(), fitWidth);
+
+    // small column is measured completely
+    ColumnFitWidthSampler samplerSmall(1, ctx);
+    samplerSmall.addGrid(grid);
+    QCOMPARE(samplerSmall.estimate(1000), fitWidth);
+    QVERIFY(samplerSmall.isExact());
+}
+
+void TestGrid::testSelectedIterator()
+{
+    auto grid = makeShared<SpaceGrid>();
+    grid->rows()->setCount(100000);
+    grid->columns()->setCount(50);
+
+    ModelSelection selection(grid);
+    selection.setSelection(makeRangeGridRect(10, 13, 3, 5));
+    selection.addSelection(makeRangeGridRect(GridID(11, 4)), true);
+    selection.addSelection(makeRangeGridRect(GridID(99999, 49)), false);
+    grid->rows()->setLineVisible(12, false);
+
+    QVector<GridID> ids;
+    for (IdIteratorSelectedVisible it(selection); it.isValid(); it.toNext())
+    {
+        GridID id = it.id().as<GridID>();
+        QCOMPARE(it.visibleId(), GridID(grid->rows()->toVisible(id.row), grid->columns()->toVisible(id.column)));
+        ids.append(id);
+    }
+    QCOMPARE(ids, QVector<GridID>() << GridID(10, 3) << GridID(10, 4) << GridID(11, 3) << GridID(99999, 49));
+
+    ids.clear();
+    for (IdIteratorSelectedVisibleByColumn it(selection, 4); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids, QVector<GridID>() << GridID(10, 4));
+
+    QVector<int> values(100000, 0);
+    ModelCallback<int> model([&values](ID id)->int {
+        return values[id.as<GridID>().row];
+    }, [&values](ID id, int value)->bool {
+        values[id.as<GridID>().row] += value;
+        return true;
+    });
+
+    QVERIFY(setValueSelected(model, selection, 1));
+    QCOMPARE(values[10], 2);
+    QCOMPARE(values[11], 1);
+    QCOMPARE(values[12], 0);
+    QCOMPARE(values[99999], 1);
+
+    // region cells are enumerated in visible order
+    grid->rows()->moveVisibleLines(11, 10);
+    QVERIFY(grid->rows()->toVisible(11) < grid->rows()->toVisible(10));
+
+    ids.clear();
+    for (IdIteratorSelectedVisible it(selection); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids, QVector<GridID>() << GridID(11, 3) << GridID(10, 3) << GridID(10, 4) << GridID(99999, 49));
+
+    ids.clear();
+    for (IdIteratorSelectedVisibleByColumn it(selection, 3); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids, QVector<GridID>() << GridID(11, 3) << GridID(10, 3));
+
+    // whole rows, whole columns and all items are clipped to the grid
+    auto smallGrid = makeShared<SpaceGrid>();
+    smallGrid->setDimensions(4, 3);
+    smallGrid->rows()->setLineVisible(2, false);
+    ModelSelection smallSelection(smallGrid);
+
+    smallSelection.setSelection(makeRangeGridRow(1));
+    ids.clear();
+    for (IdIteratorSelectedVisible it(smallSelection); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids, QVector<GridID>() << GridID(1, 0) << GridID(1, 1) << GridID(1, 2));
+
+    smallSelection.setSelection(makeRangeGridColumns(1, 3));
+    ids.clear();
+    for (IdIteratorSelectedVisible it(smallSelection); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids, QVector<GridID>() << GridID(0, 1) << GridID(0, 2) << GridID(1, 1) << GridID(1, 2) << GridID(3, 1) << GridID(3, 2));
+
+    ids.clear();
+    for (IdIteratorSelectedVisibleByColumn it(smallSelection, 2); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids, QVector<GridID>() << GridID(0, 2) << GridID(1, 2) << GridID(3, 2));
+
+    smallSelection.setSelection(makeRangeAll());
+    ids.clear();
+    for (IdIteratorSelectedVisible it(smallSelection); it.isValid(); it.toNext())
+        ids.append(it.id().as<GridID>());
+    QCOMPARE(ids.size(), 9);
+    QCOMPARE(ids.first(), GridID(0, 0));
+    QCOMPARE(ids.last(), GridID(3, 2));
+
+    values.fill(0, 4);
+    QVERIFY(setValueSelected(model, smallSelection, 1));
+    QCOMPARE(values, QVector<int>() << 3 << 3 << 0 << 3);
+}
+
+void TestGrid::testModelChangedItems()
+{
+    auto grid = makeShared<SpaceGrid>();
+    grid->setDimensions(5, 3);
+
+    QVector<ChangedItems> changes;
+    auto onModelChanged = [&changes](const Model*, const ChangedItems& items) {
+        changes.append(items);
+    };
+
+    // value per item, only the set item is changed
+    ModelStorageGrid<int> modelGrid(grid);
+    QObject::connect(&modelGrid, &Model::modelChanged, onModelChanged);
+
+    QVERIFY(modelGrid.setValue(ID(GridID(2, 1)), 7));
+    QCOMPARE(changes.size(), 1);
+    QVERIFY(!changes.last().isAll());
+    QCOMPARE(changes.last().ids, QVector<ID>() << ID(GridID(2, 1)));
+    QVERIFY(changes.last().hasItem(ID(GridID(2, 1))));
+    QVERIFY(!changes.last().hasItem(ID(GridID(2, 2))));
+
+    // value shared by row items, all items are changed
+    ModelStorageColumn<int> modelColumn(grid->rows());
+    QObject::connect(&modelColumn, &Model::modelChanged, onModelChanged);
+
+    QVERIFY(modelColumn.setValue(ID(GridID(3, 0)), 7));
+    QCOMPARE(changes.size(), 2);
+    QVERIFY(changes.last().isAll());
+    QVERIFY(changes.last().hasItem(ID(GridID(3, 2))));
+
+    // value shared by all items
+    ModelStorageValue<int> modelValue(0);
+    QObject::connect(&modelValue, &Model::modelChanged, onModelChanged);
+
+    QVERIFY(modelValue.setValue(ID(GridID(1, 1)), 7));
+    QCOMPARE(changes.size(), 3);
+    QVERIFY(changes.last().isAll());
+
+    // callback model may map several items to one value
+    int value = 0;
+    ModelCallback<int> modelCallback([&value](ID)->int {
+        return value;
+    }, [&value](ID, int newValue)->bool {
+        value = newValue;
+        return true;
+    });
+    QObject::connect(&modelCallback, &Model::modelChanged, onModelChanged);
+
+    QVERIFY(modelCallback.setValue(ID(GridID(0, 0)), 7));
+    QCOMPARE(changes.size(), 4);
+    QVERIFY(changes.last().isAll());
+}
@@ -13,6 +13,13 @@ public:
 private slots:
 
     void test();
+    void testSortColumnByModel();
+    void testSortColumnsByModels();
+    void testCacheItemFactoryGrid();
+    void testCacheSpaceScroll();
+    void testColumnFitWidthSampler();
+    void testSelectedIterator();
+    void testModelChangedItems();
 };
 
 #endif // TEST_GRID_H
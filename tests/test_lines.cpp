@@ -1,7 +1,10 @@
 #include "test_lines.h"
 #include "space/grid/Lines.h"
+#include "items/filter/FilterText.h"
+#include "core/ext/ModelStore.h"
 #include "SignalSpy.h"
 #include <QtTest/QtTest>
+#include <algorithm>
 
 using namespace Qi;
 
@@ -91,6 +94,173 @@ void TestLines::testVisibility()
     QCOMPARE(lines.isLineVisible(19), true);
 }
 
+void TestLines::testVisibilityIncremental()
+{
+    Lines lines;
+    lines.setCount(10);
+    lines.setLineSizeAll(10);
+
+    QVector<bool> filtered(10, true);
+    auto visibility = makeShared<LinesVisibilityCallback>([&filtered](int line) { return filtered[line]; });
+    lines.addLinesVisibility(visibility);
+
+    QCOMPARE(lines.visibleCount(), 10);
+
+    auto signalSpy = createSignalSpy(&lines, &Lines::linesChanged);
+
+    filtered[3] = false;
+    filtered[7] = false;
+    emit visibility->linesVisibilityChanged(visibility.data(), QVector<int>() << 3 << 7);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(signalSpy.getLast<1>(), ChangeReasonLinesVisibility);
+
+    QCOMPARE(lines.visibleCount(), 8);
+    QCOMPARE(lines.isLineVisible(3), false);
+    QCOMPARE(lines.toVisible(3), InvalidIndex);
+    QCOMPARE(lines.toVisible(4), 3);
+    QCOMPARE(lines.toVisible(8), 6);
+    QCOMPARE(lines.toAbsolute(3), 4);
+    QCOMPARE(lines.toAbsolute(7), 9);
+    QCOMPARE(lines.startPos(3), 30);
+    QCOMPARE(lines.visibleSize(), 80);
+
+    lines.setLinesVisible(QVector<int>() << 0 << 4, false);
+    QCOMPARE(signalSpy.size(), 2);
+    QCOMPARE(lines.visibleCount(), 6);
+    QCOMPARE(lines.toAbsolute(0), 1);
+    QCOMPARE(lines.toAbsolute(2), 5);
+
+    lines.setLinesVisible(QVector<int>() << 0 << 3, true);
+    QCOMPARE(lines.visibleCount(), 7);
+    QCOMPARE(lines.toAbsolute(0), 0);
+    QCOMPARE(lines.toVisible(3), InvalidIndex);
+
+    filtered[3] = true;
+    emit visibility->linesVisibilityChanged(visibility.data(), QVector<int>() << 3);
+    QCOMPARE(lines.visibleCount(), 8);
+    QCOMPARE(lines.toVisible(3), 3);
+    QCOMPARE(lines.toAbsolute(4), 5);
+}
+
+struct FilterFixture
+{
+    FilterFixture(int count)
+        : rows(makeShared<Lines>(count)),
+          model(makeShared<ModelStorageColumn<QString>>(rows)),
+          filter(makeShared<ItemsFilterTextByText>(model)),
+          rowsFilter(makeShared<RowsFilterByText>())
+    {
+        QVector<QString> texts(count);
+        for (int row = 0; row < count; ++row)
+            texts[row] = QString::number((row * 7919) % 100003);
+        model->swapValues(texts);
+
+        rowsFilter->addFilterByColumn(0, filter);
+        rows->addLinesVisibility(rowsFilter);
+    }
+
+    // visible rows as seen by lines
+    QVector<int> visibleRows() const
+    {
+        QVector<int> result;
+        for (int visibleRow = 0; visibleRow < rows->visibleCount(); ++visibleRow)
+            result.append(rows->toAbsolute(visibleRow));
+        return result;
+    }
+
+    // visible rows evaluated by per-line filter
+    QVector<int> passedRows() const
+    {
+        QVector<int> result;
+        for (int row = 0; row < rows->count(); ++row)
+        {
+            if (filter->isItemPassFilter(ID(GridID(row, 0))))
+                result.append(row);
+        }
+        return result;
+    }
+
+    SharedPtr<Lines> rows;
+    SharedPtr<ModelStorageColumn<QString>> model;
+    SharedPtr<ItemsFilterTextByText> filter;
+    SharedPtr<RowsFilterByText> rowsFilter;
+};
+
+void TestLines::testFilterBatched()
+{
+    FilterFixture fixture(1000);
+    QCOMPARE(fixture.rows->visibleCount(), 1000);
+
+    fixture.filter->setFilterText("1");
+    QVector<int> passedRows = fixture.passedRows();
+    QVERIFY(!passedRows.isEmpty() && passedRows.size() < 1000);
+    QCOMPARE(fixture.visibleRows(), passedRows);
+
+    for (int row = 0; row < 1000; ++row)
+        QCOMPARE(fixture.rowsFilter->isLineVisible(row), passedRows.contains(row));
+
+    // not a refinement of "1"
+    fixture.filter->setFilterText("7");
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+}
+
+void TestLines::testFilterParallel()
+{
+    // enough rows to be split between threads
+    const int count = 100000;
+    FilterFixture fixture(count);
+    fixture.rowsFilter->setParallel(true);
+
+    fixture.filter->setFilterText("3");
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+
+    fixture.filter->setFilterText("90");
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+
+    // parallel and batched passes agree
+    FilterFixture fixtureBatched(count);
+    fixtureBatched.filter->setFilterText("90");
+    QCOMPARE(fixtureBatched.visibleRows(), fixture.visibleRows());
+}
+
+void TestLines::testFilterRefine()
+{
+    // several refinement chunks
+    const int count = 200000;
+    FilterFixture fixture(count);
+
+    fixture.filter->setFilterText("1");
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+
+    auto signalSpy = createSignalSpy(fixture.rowsFilter.data(), &LinesVisibility::visibilityChanged);
+
+    // refinement hides lines chunk by chunk without full pass
+    fixture.filter->setFilterText("12");
+    QTRY_COMPARE(fixture.visibleRows(), fixture.passedRows());
+    QCOMPARE(signalSpy.size(), 0);
+
+    // refinement restarted by another refinement
+    fixture.filter->setFilterText("123");
+    fixture.filter->setFilterText("1234");
+    QTRY_COMPARE(fixture.visibleRows(), fixture.passedRows());
+    QCOMPARE(signalSpy.size(), 0);
+
+    // not a refinement does full pass
+    fixture.filter->setFilterText("2");
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+
+    // not a refinement aborts in-flight refinement
+    fixture.filter->setFilterText("23");
+    fixture.filter->setFilterText("5");
+    QCOMPARE(signalSpy.size(), 2);
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+
+    // stale refinement chunks don't change result
+    QTest::qWait(50);
+    QCOMPARE(fixture.visibleRows(), fixture.passedRows());
+}
+
 void TestLines::testSizes()
 {
     Lines lines;
@@ -342,3 +512,144 @@ void TestLines::testSizeAtLine()
     QCOMPARE(lines.visibleSize(), 62);
 }
 
+void TestLines::testSizeAtLineUpdate()
+{
+    Lines lines;
+    lines.setCount(10);
+
+    lines.setLineSizeAll(10);
+
+    QCOMPARE(lines.startPos(5), 50);
+    QCOMPARE(lines.visibleSize(), 100);
+
+    // positions index is patched after validation
+    lines.setLineSize(2, 30);
+    QCOMPARE(lines.startPos(2), 20);
+    QCOMPARE(lines.startPos(3), 50);
+    QCOMPARE(lines.endPos(9), 120);
+    QCOMPARE(lines.findVisibleIDByPos(49), 2);
+    QCOMPARE(lines.findVisibleIDByPos(50), 3);
+
+    lines.setLineVisible(2, false);
+    QCOMPARE(lines.visibleCount(), 9);
+    QCOMPARE(lines.startPos(2), 20);
+    QCOMPARE(lines.toAbsolute(2), 3);
+    QCOMPARE(lines.findVisibleIDByPos(25), 2);
+    QCOMPARE(lines.visibleSize(), 90);
+
+    lines.setLineSize(2, 5);
+    QCOMPARE(lines.visibleSize(), 90);
+
+    lines.setLineVisible(2, true);
+    QCOMPARE(lines.visibleCount(), 10);
+    QCOMPARE(lines.startPos(3), 25);
+    QCOMPARE(lines.findVisibleIDByPos(24), 2);
+    QCOMPARE(lines.findVisibleIDByPos(25), 3);
+    QCOMPARE(lines.visibleSize(), 95);
+
+    lines.setLineSize(0, 0);
+    QCOMPARE(lines.startPos(1), 0);
+    QCOMPARE(lines.findVisibleIDByPos(5, 0, 2), 1);
+    QCOMPARE(lines.findVisibleIDByPos(5, 2, 4), InvalidIndex);
+}
+
+void TestLines::testSortParallel()
+{
+    const int count = 100000;
+
+    // few distinct keys to check stability
+    QVector<int> keys(count);
+    for (int i = 0; i < count; ++i)
+        keys[i] = (i * 7919) % 101;
+
+    auto lessThan = [&keys](int left, int right)->bool {
+        return keys[left] < keys[right];
+    };
+
+    Lines serialLines;
+    serialLines.setCount(count);
+    serialLines.sort(true, lessThan);
+
+    Lines parallelLines;
+    parallelLines.setCount(count);
+
+    auto signalSpy = createSignalSpy(&parallelLines, &Lines::linesChanged);
+    parallelLines.sort(true, lessThan, true);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(signalSpy.getLast<1>(), ChangeReasonLinesOrder);
+
+    QCOMPARE(parallelLines.permutation(), serialLines.permutation());
+}
+
+void TestLines::testResort()
+{
+    QVector<int> keys;
+    keys << 5 << 1 << 4 << 2 << 3 << 2;
+
+    auto lessThan = [&keys](int left, int right)->bool {
+        return keys[left] < keys[right];
+    };
+
+    Lines lines;
+    lines.setCount(keys.size());
+    lines.sort(true, lessThan);
+    QCOMPARE(lines.permutation(), QVector<int>() << 1 << 3 << 5 << 4 << 2 << 0);
+
+    auto signalSpy = createSignalSpy(&lines, &Lines::linesChanged);
+
+    keys[0] = 0;
+    keys[1] = 2;
+    lines.resort(QVector<int>() << 0 << 1 << 0, lessThan);
+    QCOMPARE(signalSpy.size(), 1);
+    QCOMPARE(signalSpy.getLast<1>(), ChangeReasonLinesOrder);
+    // changed line goes after equal lines
+    QCOMPARE(lines.permutation(), QVector<int>() << 0 << 3 << 5 << 1 << 4 << 2);
+
+    lines.resort(QVector<int>(), lessThan);
+    QCOMPARE(signalSpy.size(), 1);
+}
+
+void TestLines::testResortIncremental()
+{
+    const int count = 1000;
+    QVector<int> keys(count);
+    for (int i = 0; i < count; ++i)
+        keys[i] = (i * 37) % 50;
+
+    auto lessThan = [&keys](int left, int right)->bool {
+        return keys[left] < keys[right];
+    };
+
+    Lines lines(count);
+    for (int i = 0; i < count; i += 7)
+        lines.setLineVisible(i, false);
+    lines.sort(true, lessThan);
+
+    for (int round = 0; round < 50; ++round)
+    {
+        QVector<int> changed;
+        for (int i = 0; i < 20; ++i)
+        {
+            int line = (round * 131 + i * 53) % count;
+            keys[line] = (keys[line] + round + i) % 50;
+            changed.append(line);
+        }
+
+        lines.resort(changed, lessThan);
+
+        // visible lines stay sorted and positions are consistent
+        QCOMPARE(lines.visibleCount(), count - (count + 6) / 7);
+        for (int visibleLine = 0; visibleLine < lines.visibleCount(); ++visibleLine)
+        {
+            int line = lines.toAbsolute(visibleLine);
+            QCOMPARE(lines.toVisible(line), visibleLine);
+            QCOMPARE(lines.startPos(visibleLine), visibleLine * lines.lineSize(line));
+            if (visibleLine > 0)
+                QVERIFY(!lessThan(line, lines.toAbsolute(visibleLine - 1)));
+        }
+    }
+
+    QVector<int> permutation = lines.permutation();
+    QCOMPARE(permutation.size(), count);
+    QVERIFY(std::is_sorted(permutation.begin(), permutation.end(), lessThan));
+}
@@ -14,9 +14,17 @@ private slots:
 
     void testCount();
     void testVisibility();
+    void testVisibilityIncremental();
+    void testFilterBatched();
+    void testFilterParallel();
+    void testFilterRefine();
     void testSizes();
     void testAbsVsVis();
     void testSizeAtLine();
+    void testSizeAtLineUpdate();
+    void testSortParallel();
+    void testResort();
+    void testResortIncremental();
 };
 
 #endif // TEST_LINES_H
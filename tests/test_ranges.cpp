@@ -3,6 +3,8 @@
 #include "SignalSpy.h"
 #include <QtTest/QtTest>
 #include "space/grid/RangeGrid.h"
+#include "space/grid/GridRegion.h"
+#include "utils/IntervalSet.h"
 
 using namespace Qi;
 
@@ -81,7 +83,7 @@ void TestRanges::testRangeColumns()
         QSet<int> columns;
         RangeGridColumns r(columns);
         QVERIFY(!r.parent());
-        QCOMPARE(r.columns(), QSet<int>());
+        QCOMPARE(r.columnIntervals().toSet(), QSet<int>());
         QVERIFY(!r.hasItem(0, 0));
     }
     
@@ -108,7 +110,7 @@ void TestRanges::testRangeColumns()
         QVERIFY(r.data());
         QSet<int> columns;
         columns << 0 << 1 << 2 << 3 << 4 << 5 << 6 << 7 << 8 << 9;
-        QVERIFY(r->columns() == columns);
+        QVERIFY(r->columnIntervals().toSet() == columns);
         
         auto signalSpy = createSignalSpy(r.data(), &Range::rangeChanged);
         QCOMPARE(signalSpy.empty(), true);
@@ -130,7 +132,7 @@ void TestRanges::testRangeColumns()
         columns << 0 << 10;
         SharedPtr<RangeGridColumns> r(makeRangeGridColumns(columns));
         QVERIFY(r.data());
-        QVERIFY(r->columns() == columns);
+        QVERIFY(r->columnIntervals().toSet() == columns);
         QVERIFY(r->hasItem(9, 10));
         QVERIFY(!r->hasItem(8, 8));
     }
@@ -175,7 +177,7 @@ void TestRanges::testRangeRows()
         QSet<int> rows;
         RangeGridRows r(rows);
         QVERIFY(!r.parent());
-        QCOMPARE(r.rows(), QSet<int>());
+        QCOMPARE(r.rowIntervals().toSet(), QSet<int>());
         QVERIFY(!r.hasItem(0, 0));
     }
     
@@ -202,7 +204,7 @@ void TestRanges::testRangeRows()
         QVERIFY(r.data());
         QSet<int> rows;
         rows << 0 << 1 << 2 << 3 << 4 << 5 << 6 << 7 << 8 << 9;
-        QVERIFY(r->rows() == rows);
+        QVERIFY(r->rowIntervals().toSet() == rows);
         
         auto signalSpy = createSignalSpy(r.data(), &Range::rangeChanged);
         QCOMPARE(signalSpy.size(), 0);
@@ -224,8 +226,178 @@ void TestRanges::testRangeRows()
         rows << 0 << 10;
         SharedPtr<RangeGridRows> r(makeRangeGridRows(rows));
         QVERIFY(r.data());
-        QVERIFY(r->rows() == rows);
+        QVERIFY(r->rowIntervals().toSet() == rows);
         QVERIFY(r->hasItem(10, 9));
         QVERIFY(!r->hasItem(8, 8));
     }
+
+    {
+        // large ranges are kept as intervals
+        auto r = makeRangeGridRows(0, 1000000);
+        QCOMPARE(r->rowIntervals().intervals().size(), 1);
+        QVERIFY(r->hasItem(999999, 3));
+        QVERIFY(!r->hasItem(1000000, 3));
+
+        auto signalSpy = createSignalSpy(r.data(), &Range::rangeChanged);
+        r->setRowIntervals(IntervalSet(0, 1000000));
+        QCOMPARE(signalSpy.size(), 0);
+
+        QSet<int> rows;
+        rows << 5 << 7 << 6 << 20;
+        r->setRows(rows);
+        QCOMPARE(signalSpy.size(), 1);
+        QCOMPARE(r->rowIntervals().intervals().size(), 2);
+        QVERIFY(r->rowIntervals().toSet() == rows);
+    }
+}
+
+void TestRanges::testIntervalSet()
+{
+    IntervalSet s;
+    QVERIFY(s.isEmpty());
+    QVERIFY(!s.contains(0));
+
+    s.insert(10, 20);
+    s.insert(30, 40);
+    QCOMPARE(s.intervals().size(), 2);
+    QVERIFY(s.contains(10));
+    QVERIFY(s.contains(19));
+    QVERIFY(!s.contains(20));
+    QVERIFY(!s.contains(9));
+
+    // adjacent intervals are coalesced
+    s.insert(20, 30);
+    QCOMPARE(s.intervals().size(), 1);
+    QCOMPARE(s.count(), 30);
+
+    s.remove(15, 25);
+    QCOMPARE(s.intervals().size(), 2);
+    QVERIFY(s.contains(14));
+    QVERIFY(!s.contains(15));
+    QVERIFY(!s.contains(24));
+    QVERIFY(s.contains(25));
+
+    IntervalSet other(0, 12);
+    s.subtract(other);
+    QVERIFY(!s.contains(11));
+    QVERIFY(s.contains(12));
+
+    s.unite(other);
+    QVERIFY(s.contains(0));
+    QVERIFY(s.contains(14));
+    QCOMPARE(s.intersected(IntervalSet(14, 26)), IntervalSet::fromValues(QVector<int>() << 14 << 25));
+
+    QSet<int> values;
+    values << 3 << 1 << 2 << 7;
+    IntervalSet fromValues = IntervalSet::fromSet(values);
+    QCOMPARE(fromValues.intervals().size(), 2);
+    QVERIFY(fromValues.toSet() == values);
+}
+
+void TestRanges::testGridRegion()
+{
+    GridRegion r;
+    QVERIFY(r.isEmpty());
+
+    r.unite(IntervalSet(0, 10), IntervalSet(0, 5));
+    r.unite(IntervalSet(10, 20), IntervalSet(0, 5));
+    // bands with equal columns are merged
+    QCOMPARE(r.bands().size(), 1);
+    QVERIFY(r.contains(19, 4));
+    QVERIFY(!r.contains(20, 4));
+    QVERIFY(!r.contains(5, 5));
+
+    r.subtract(IntervalSet(5, 6), IntervalSet::all());
+    QCOMPARE(r.bands().size(), 2);
+    QVERIFY(!r.contains(5, 0));
+    QVERIFY(r.contains(4, 0));
+    QVERIFY(r.contains(6, 0));
+
+    r.unite(IntervalSet(3, 8), IntervalSet(100, 101));
+    QVERIFY(r.contains(5, 100));
+    QVERIFY(!r.contains(8, 100));
+    QVERIFY(r.contains(8, 0));
+
+    r.subtract(IntervalSet::all(), IntervalSet::all());
+    QVERIFY(r.isEmpty());
+}
+
+void TestRanges::testRangeSelection()
+{
+    RangeSelection s;
+    QVERIFY(s.isEmpty());
+    QVERIFY(!s.hasItem(makeID<GridID>(0, 0)));
+
+    auto signalSpy = createSignalSpy(&s, &Range::rangeChanged);
+
+    s.addRange(makeRangeGridRect(0, 10, 0, 10), false);
+    QCOMPARE(signalSpy.size(), 1);
+    QVERIFY(s.hasItem(makeID<GridID>(9, 9)));
+    QVERIFY(!s.hasItem(makeID<GridID>(10, 9)));
+
+    // toggle lots of single cells
+    for (int i = 0; i < 1000; ++i)
+    {
+        GridID id(i % 20, i % 7);
+        s.addRange(makeRangeGridRect(id), s.hasItem(ID(id)));
+    }
+    QCOMPARE(signalSpy.size(), 1001);
+
+    s.addRange(makeRangeGridRows(5, 6), false);
+    QVERIFY(s.hasItem(makeID<GridID>(5, InvalidIndex)));
+    QVERIFY(s.hasItem(makeID<GridID>(5, 1000)));
+
+    s.addRange(makeRangeGridColumn(3), true);
+    QVERIFY(!s.hasItem(makeID<GridID>(5, 3)));
+    QVERIFY(s.hasItem(makeID<GridID>(5, 4)));
+
+    // non grid ranges keep their order
+    s.addRange(makeShared<RangeGridCallback>([](GridID id) { return id.row == 100; }), false);
+    s.addRange(makeRangeGridRect(100, 101, 0, 2), true);
+    QVERIFY(s.hasItem(makeID<GridID>(100, 5)));
+    QVERIFY(!s.hasItem(makeID<GridID>(100, 1)));
+    QVERIFY(s.hasItem(makeID<GridID>(100, 3)));
+    QVERIFY(!s.hasItem(makeID<GridID>(5, 3)));
+
+    RangeSelection copy(s);
+    QVERIFY(copy.hasItem(makeID<GridID>(100, 5)));
+    QVERIFY(!copy.hasItem(makeID<GridID>(100, 1)));
+
+    s.addRange(makeRangeAll(), true);
+    QVERIFY(!s.hasItem(makeID<GridID>(100, 5)));
+    QVERIFY(!s.hasItem(makeID<GridID>(0, 0)));
+
+    s.addRange(makeRangeAll(), false);
+    QVERIFY(s.hasItem(makeID<GridID>(100, 5)));
+
+    s.clear();
+    QVERIFY(s.isEmpty());
+    QVERIFY(!s.hasItem(makeID<GridID>(100, 5)));
+}
+
+void TestRanges::testGridStructure()
+{
+    IntervalSet rows, columns;
+
+    QVERIFY(makeRangeAll()->gridStructure(rows, columns));
+    QCOMPARE(rows, IntervalSet::all());
+    QCOMPARE(columns, IntervalSet::all());
+
+    QVERIFY(makeRangeNone()->gridStructure(rows, columns));
+    QVERIFY(rows.isEmpty());
+
+    QVERIFY(makeRangeGridRect(2, 5, 1, 3)->gridStructure(rows, columns));
+    QCOMPARE(rows, IntervalSet(2, 5));
+    QCOMPARE(columns, IntervalSet(1, 3));
+
+    QVERIFY(makeRangeGridRow(7)->gridStructure(rows, columns));
+    QCOMPARE(rows, IntervalSet(7, 8));
+    QCOMPARE(columns, IntervalSet::all());
+
+    QVERIFY(makeRangeGridColumns(0, 4)->gridStructure(rows, columns));
+    QCOMPARE(rows, IntervalSet::all());
+    QCOMPARE(columns, IntervalSet(0, 4));
+
+    QVERIFY(!makeRangeID(ID(1))->gridStructure(rows, columns));
+    QVERIFY(!makeShared<RangeGridCallback>()->gridStructure(rows, columns));
 }
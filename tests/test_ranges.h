@@ -18,6 +18,10 @@ private slots:
     void testRangeColumns();
     void testRangeRow();
     void testRangeRows();
+    void testIntervalSet();
+    void testGridRegion();
+    void testRangeSelection();
+    void testGridStructure();
 };
 
 #endif // TEST_RANGES_H